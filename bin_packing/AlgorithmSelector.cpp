@@ -0,0 +1,199 @@
+#include "AlgorithmSelector.h"
+#include "ResultInterface.h"
+#include "Algorithms.h"
+#include "Packing.h"
+#include "Threads.h"
+#include "NullBuffer.h"
+
+#include <iostream>
+#include <string>
+#include <cmath>
+#include <algorithm>
+
+namespace bin_packing
+{
+	typedef AlgorithmSelector::Configuration Configuration;
+
+	static const Configuration candidates[] = {
+		{ AlgorithmSelector::HillClimbing, Context::MinimumBinSlack, 0, 0.0 },
+		{ AlgorithmSelector::HillClimbing, Context::RandomFirstFit, 0, 0.0 },
+		{ AlgorithmSelector::TabuSearch, Context::RandomFirstFit, 500, 0.4 },
+		{ AlgorithmSelector::TabuSearch, Context::MinimumBinSlack, 200, 0.4 },
+		{ AlgorithmSelector::ReactiveTabuSearch, Context::MinimumBinSlack, 500, 0.0 },
+		{ AlgorithmSelector::ReactiveTabuSearch, Context::MinimumBinSlack, 2000, 0.0 },
+		{ AlgorithmSelector::ReactiveTabuSearch, Context::RandomFirstFit, 2000, 0.0 },
+		{ AlgorithmSelector::LargeNeighbourhoodSearch, Context::MinimumBinSlack, 1000, 0.0 }
+	};
+	static const size_t candidatesCount = sizeof(candidates) / sizeof(candidates[0]);
+
+	// Output of tune() over the first four data sets of data/binpack1-8.
+	// Classes that do not occur there keep reactive tabu search from MBS.
+	static const size_t calibratedCandidates[AlgorithmSelector::classesCount] = { 7, 7, 5, 6, 5, 5, 5, 6, 5, 5, 5, 5 };
+
+	static const char* enginesNames[] = { "hillClimbing", "tabuSearch", "reactiveTabuSearch", "largeNeighbourhoodSearch" };
+	static const char* generatorsNames[] = { "randomFirstFit", "minimumBinSlack" };
+
+	static size_t lowerBoundL2(std::vector<double>& weights, double capacity)
+	{
+		std::sort(weights.begin(), weights.end());
+		std::vector<double> prefix(weights.size() + 1, 0.0);
+		for (size_t i = 0; i < weights.size(); ++i)
+			prefix[i + 1] = prefix[i] + weights[i];
+
+		double half = capacity / 2.0;
+		size_t upToHalf = std::upper_bound(weights.begin(), weights.end(), half) - weights.begin();
+		size_t bound = 0;
+		for (size_t a = 0; a <= upToHalf; ++a) {
+			if (a > 0 && a < upToHalf && weights[a] == weights[a - 1])
+				continue;
+			double alpha = a < upToHalf ? weights[a] : 0.0;
+			size_t upToLarge = std::upper_bound(weights.begin(), weights.end(), capacity - alpha) - weights.begin();
+			size_t fromAlpha = std::lower_bound(weights.begin(), weights.end(), alpha) - weights.begin();
+
+			size_t largeCount = weights.size() - upToHalf;
+			double mediumResidual = static_cast<double>(upToLarge - upToHalf) * capacity - (prefix[upToLarge] - prefix[upToHalf]);
+			double smallWeight = prefix[upToHalf] - prefix[fromAlpha];
+			size_t extra = 0;
+			if (smallWeight > mediumResidual)
+				extra = static_cast<size_t>(std::ceil((smallWeight - mediumResidual) / capacity - 1e-9));
+			bound = std::max(bound, largeCount + extra);
+		}
+		return bound;
+	}
+
+	InstanceFeatures instanceFeatures(const Context& context)
+	{
+		InstanceFeatures features;
+		double capacity = context.containerCapacity();
+		size_t itemsCount = context.itemsCount();
+		features.itemsCount = itemsCount;
+
+		std::vector<double> weights(itemsCount);
+		features.triplets = itemsCount % 3 == 0;
+		for (size_t i = 0; i < itemsCount; ++i) {
+			double weight = context.itemWeight(i);
+			double relative = weight / capacity;
+			weights[i] = weight;
+			if (relative < 0.25 || relative > 0.5)
+				features.triplets = false;
+		}
+		features.lowerBound = lowerBoundL2(weights, capacity);
+
+		Packing packing(&context);
+		packing.bestFitDecreasing();
+		features.bestFitContainers = packing.containersCount();
+		return features;
+	}
+
+	AlgorithmSelector::AlgorithmSelector() : table_(classesCount)
+	{
+		for (size_t instance = 0; instance < classesCount; ++instance)
+			table_[instance] = candidates[calibratedCandidates[instance]];
+	}
+
+	size_t AlgorithmSelector::instanceClass(const InstanceFeatures& features)
+	{
+		size_t size = features.itemsCount < 300 ? 0 : (features.itemsCount < 1000 ? 1 : 2);
+		size_t open = features.bestFitContainers > features.lowerBound ? 1 : 0;
+		return size * 4 + (features.triplets ? 2 : 0) + open;
+	}
+
+	const Configuration& AlgorithmSelector::select(const InstanceFeatures& features) const
+	{
+		return table_[instanceClass(features)];
+	}
+
+	ResultInterface* AlgorithmSelector::solve(Context& context) const
+	{
+		const Configuration& configuration = select(instanceFeatures(context));
+		context.setStartGenerator(configuration.startGenerator);
+		switch (configuration.engine) {
+		case HillClimbing:
+			return hillClimbing(context, DontLookBits);
+		case TabuSearch:
+			return tabuSearch(context, configuration.maxSteps, configuration.tenureFactor);
+		case LargeNeighbourhoodSearch:
+			if (context.weightOnly())
+				return largeNeighbourhoodSearch(context, 3, configuration.maxSteps);
+			break;
+		default:
+			break;
+		}
+		return reactiveTabuSearch(context, configuration.maxSteps);
+	}
+
+	void AlgorithmSelector::tune(const std::vector<Context*>& contexts)
+	{
+		std::vector<size_t> excess(classesCount * candidatesCount, 0);
+		std::vector<double> seconds(classesCount * candidatesCount, 0.0);
+		std::vector<bool> seen(classesCount, false);
+
+		NullBuffer silence;
+		std::ostream quiet(&silence);
+		for (size_t i = 0; i < contexts.size(); ++i) {
+			Context& context = *contexts[i];
+			size_t instance = instanceClass(instanceFeatures(context));
+			seen[instance] = true;
+			std::ostream& report = context.log();
+			report << "Instance " << i << ", class " << instance << ':';
+			context.setLog(quiet);
+			for (size_t c = 0; c < candidatesCount; ++c) {
+				table_[instance] = candidates[c];
+				context.random().seed(0);
+				double start = wallSeconds();
+				ResultInterface* result = solve(context);
+				double elapsed = wallSeconds() - start;
+
+				size_t above = result->containersCount() - std::min(result->containersCount(), context.bestKnownNumberOfContainers());
+				excess[instance * candidatesCount + c] += above;
+				seconds[instance * candidatesCount + c] += elapsed;
+				report << ' ' << above;
+				delete result;
+			}
+			context.setLog(report);
+			report << std::endl;
+		}
+
+		for (size_t instance = 0; instance < classesCount; ++instance) {
+			if (!seen[instance])
+				continue;
+			size_t best = 0;
+			for (size_t c = 1; c < candidatesCount; ++c) {
+				size_t k = instance * candidatesCount + c;
+				size_t b = instance * candidatesCount + best;
+				if (excess[k] < excess[b] || (excess[k] == excess[b] && seconds[k] < seconds[b]))
+					best = c;
+			}
+			table_[instance] = candidates[best];
+		}
+	}
+
+	void AlgorithmSelector::write(std::ostream& stream) const
+	{
+		for (size_t instance = 0; instance < classesCount; ++instance) {
+			const Configuration& configuration = table_[instance];
+			stream << instance << ' ' << enginesNames[configuration.engine] << ' ' << generatorsNames[configuration.startGenerator] << ' '
+				<< configuration.maxSteps << ' ' << configuration.tenureFactor << '\n';
+		}
+	}
+
+	void AlgorithmSelector::read(std::istream& stream)
+	{
+		size_t instance;
+		std::string engine, generator;
+		Configuration configuration;
+		while (stream >> instance >> engine >> generator >> configuration.maxSteps >> configuration.tenureFactor) {
+			if (instance >= classesCount)
+				throw 1;
+			size_t e = std::find(enginesNames, enginesNames + 4, engine) - enginesNames;
+			size_t g = std::find(generatorsNames, generatorsNames + 2, generator) - generatorsNames;
+			if (e == 4 || g == 2)
+				throw 1;
+			configuration.engine = static_cast<Engine>(e);
+			configuration.startGenerator = static_cast<Context::StartGenerator>(g);
+			table_[instance] = configuration;
+		}
+		if (!stream.eof())
+			throw 1;
+	}
+}
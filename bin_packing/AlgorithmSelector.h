@@ -0,0 +1,67 @@
+#ifndef ALGORITHM_SELECTOR_H
+#define ALGORITHM_SELECTOR_H
+
+#include "Context.h"
+
+#include <cstddef>
+#include <iosfwd>
+#include <vector>
+
+namespace bin_packing
+{
+	class ResultInterface;
+
+	// Cheap description of an instance: the weight distribution as far as
+	// it tells triplets apart, the Martello-Toth L2 lower bound and the
+	// number of containers best fit decreasing needs, all in O(n log n).
+	struct InstanceFeatures
+	{
+		size_t itemsCount;
+		bool triplets;
+		size_t lowerBound;
+		size_t bestFitContainers;
+	};
+
+	InstanceFeatures instanceFeatures(const Context& context);
+
+	// Picks the search engine, start generator and parameters for an
+	// instance from a table indexed by its class: small (below 300 items),
+	// medium (below 1000) or large, triplets (every item from a quarter to
+	// a half of the capacity) or not, and whether best fit decreasing
+	// already meets L2. The built-in table comes from tune() over data/;
+	// tune() can calibrate it again on other instances, and write() and
+	// read() keep the result as text.
+	class AlgorithmSelector
+	{
+	public:
+		enum Engine { HillClimbing, TabuSearch, ReactiveTabuSearch, LargeNeighbourhoodSearch };
+		enum { classesCount = 12 };
+
+		struct Configuration
+		{
+			Engine engine;
+			Context::StartGenerator startGenerator;
+			size_t maxSteps;
+			double tenureFactor;
+		};
+
+		AlgorithmSelector();
+
+		static size_t instanceClass(const InstanceFeatures& features);
+		const Configuration& select(const InstanceFeatures& features) const;
+		ResultInterface* solve(Context& context) const;
+
+		// Runs every candidate configuration on every context and keeps, for
+		// each class that occurs, the one that ends the fewest containers
+		// above the best known numbers in total, then the fastest.
+		void tune(const std::vector<Context*>& contexts);
+
+		void write(std::ostream& stream) const;
+		void read(std::istream& stream);
+
+	private:
+		std::vector<Configuration> table_;
+	};
+}
+
+#endif // ALGORITHM_SELECTOR_H
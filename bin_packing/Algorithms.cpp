@@ -1,180 +1,1389 @@
 #include "Algorithms.h"
 
 #include "Context.h"
+#include "ElitePool.h"
+#include "Island.h"
 #include "ResultInterface.h"
-#include "Range.h"
+#include "Neighbourhoods.h"
+#include "Packing.h"
+#include "Result.h"
+#include "SubsetSum.h"
+#include "Serialization.h"
+#include "VisitedCache.h"
+#include "Threads.h"
 
 #include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdio>
 #include <ctime>
 #include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <deque>
+#include <algorithm>
 
 namespace bin_packing
 {
-	ResultInterface* hillClimbing(Context& context)
+	static bool bestImprovement(const Context& context, const ResultInterface& result, const ContainersItems& containersItems, Move& move)
 	{
-		ResultInterface* currentResult = context.createRandomResult();
+		BestMove bestMove(context, result);
+		Relocations::visit(context, result, containersItems, bestMove);
+		if (!bestMove.found() || !context.deletesContainer(bestMove.move()))
+			Exchanges::visit(context, result, containersItems, bestMove);
 
-		std::cout << "F: " << currentResult->toString() << '\n';
+		if (bestMove.found())
+			move = bestMove.move();
+		return bestMove.found();
+	}
 
-        size_t stepsCount = 0;
-		while (true) {
-            stepsCount++;
+	static bool improvementFrom(const Context& context, const ResultInterface& result, const ContainersItems& containersItems, size_t container, Move& move)
+	{
+		FirstMove firstMove(context, result);
+		if (Relocations::visitFrom(context, result, containersItems, container, firstMove))
+			Exchanges::visitFrom(context, result, containersItems, container, firstMove);
 
-			ResultInterface::NeighbourRange* range = currentResult->neighbours();
-			ResultInterface* bestNeighbour = 0;
+		if (firstMove.found())
+			move = firstMove.move();
+		return firstMove.found();
+	}
 
-			while (!range->empty()) {
-				ResultInterface* neighbour = range->next();
+	static void shuffledContainers(Random& random, size_t containersCount, std::vector<size_t>& containers)
+	{
+		containers.resize(containersCount);
+		for (size_t c = 0; c < containersCount; ++c)
+			containers[c] = c;
+		for (size_t c = containersCount; c > 1; --c)
+			std::swap(containers[c - 1], containers[random.below(c)]);
+	}
 
-				if (bestNeighbour == 0 || context.less(*neighbour, *bestNeighbour)) {
-					delete bestNeighbour;
-					bestNeighbour = neighbour;
-				} else {
-					delete neighbour;
-				}
+	static bool firstImprovement(const Context& context, const ResultInterface& result, const ContainersItems& containersItems, Move& move)
+	{
+		std::vector<size_t> containers;
+		shuffledContainers(context.random(), result.containersCount(), containers);
+		for (size_t c = 0; c < containers.size(); ++c)
+			if (improvementFrom(context, result, containersItems, containers[c], move))
+				return true;
+		return false;
+	}
+
+	// Don't look bits: after the first sweep over all containers only those
+	// changed by the latest moves are scanned again, most recent first, and
+	// at most dontLookCandidates of them are remembered.
+	static const size_t dontLookCandidates = 64;
+
+	static bool dontLookImprovement(const Context& context, const ResultInterface& result, const ContainersItems& containersItems, std::vector<size_t>& pending, std::deque<size_t>& recent, Move& move)
+	{
+		while (!recent.empty() || !pending.empty()) {
+			size_t container;
+			if (!recent.empty()) {
+				container = recent.back();
+				recent.pop_back();
+			} else {
+				container = pending.back();
+				pending.pop_back();
 			}
-			delete range;
 
-			if (bestNeighbour) {
-				// std::cout << "BN: " << bestNeighbour->toString() << '\n';
+			if (container < result.containersCount() && improvementFrom(context, result, containersItems, container, move)) {
+				recent.push_back(container);
+				return true;
 			}
+		}
+		return false;
+	}
 
-			if (bestNeighbour && context.less(*bestNeighbour, *currentResult)) {
-				ResultInterface* oldResult = currentResult;
-				currentResult = bestNeighbour->clone();
-				delete bestNeighbour;
-				delete oldResult;
-			} else {
-				ResultInterface* result = currentResult->clone();
-				if (bestNeighbour)
-					delete bestNeighbour;
+	static void lookAgain(const Move& move, std::deque<size_t>& recent)
+	{
+		for (size_t k = 0; k < move.length; ++k) {
+			size_t ends[2] = { move.fromContainers[k], move.toContainers[k] };
+			for (size_t e = 0; e < 2; ++e) {
+				std::deque<size_t>::iterator i = std::find(recent.begin(), recent.end(), ends[e]);
+				if (i != recent.end())
+					recent.erase(i);
+				recent.push_back(ends[e]);
+			}
+		}
+		while (recent.size() > dontLookCandidates)
+			recent.pop_front();
+	}
+
+	static ResultInterface* climb(Context& context, ResultInterface* currentResult, ClimbingStrategy strategy, size_t& stepsCount)
+	{
+		ContainersItems containersItems;
+		collectContainersItems(*currentResult, containersItems);
 
-				delete currentResult;
-				std::cout << "R: " << result->toString() << '\n';
-                std::cout << "S: " << stepsCount << '\n';
+		std::vector<size_t> pending;
+		std::deque<size_t> recent;
+		if (strategy == DontLookBits)
+			shuffledContainers(context.random(), currentResult->containersCount(), pending);
+
+		stepsCount = 0;
+		while (true) {
+            stepsCount++;
 
-				// std::cout << result->toGeneralString() << std::endl;
-				return result;
+			Move move;
+			bool found = false;
+			switch (strategy) {
+			case BestImprovement:
+				found = bestImprovement(context, *currentResult, containersItems, move);
+				break;
+			case FirstImprovement:
+				found = firstImprovement(context, *currentResult, containersItems, move);
+				break;
+			case DontLookBits:
+				found = dontLookImprovement(context, *currentResult, containersItems, pending, recent, move);
+				break;
+			}
+
+			if (found) {
+				currentResult->apply(move);
+				updateContainersItems(context, containersItems, move);
+				if (strategy == DontLookBits)
+					lookAgain(move, recent);
+			} else {
+				return currentResult;
 			}
 		}
 	}
 
+	ResultInterface* hillClimbing(Context& context, ClimbingStrategy strategy)
+	{
+		ResultInterface* currentResult = context.createRandomResult();
+
+		context.log() << "F: " << currentResult->toString() << '\n';
+
+		size_t stepsCount = 0;
+		ResultInterface* result = climb(context, currentResult, strategy, stepsCount);
+
+		context.log() << "R: " << result->toString() << '\n';
+		context.log() << "S: " << stepsCount << '\n';
+
+		// context.log() << result->toGeneralString() << std::endl;
+		return result;
+	}
+
+	ResultInterface* hillClimbing(Context& context, ResultInterface* initialResult, ClimbingStrategy strategy)
+	{
+		size_t stepsCount = 0;
+		return climb(context, initialResult, strategy, stepsCount);
+	}
+
+	class TabuMove
+	{
+	public:
+		TabuMove(const Context& context, const ResultInterface& result, size_t** shortTermMemory) : context_(context), result_(result),
+			shortTermMemory_(shortTermMemory), found_(false), foundTabu_(false), minTabu_(0), deletesContainer_(false)
+		{
+		}
+
+		bool operator()(const Move& move)
+		{
+			if (move.kind == Move::Relocation && context_.deletesContainer(move))
+				deletesContainer_ = true;
+
+			size_t overallTabu = 0;
+			for (size_t k = 0; k < move.length; ++k)
+				if (shortTermMemory_[move.fromContainers[k]][context_.itemClass(move.items[k])] > 0)
+					overallTabu += shortTermMemory_[move.fromContainers[k]][context_.itemClass(move.items[k])];
+
+			if (overallTabu > 0) {
+				if (!foundTabu_ || overallTabu < minTabu_) {
+					tabuMove_ = move;
+					minTabu_ = overallTabu;
+					foundTabu_ = true;
+				}
+			} else if (!found_ || context_.less(result_, move, move_)) {
+				move_ = move;
+				found_ = true;
+			}
+			return true;
+		}
+
+		bool found() const
+		{
+			return found_;
+		}
+
+		const Move& move() const
+		{
+			return move_;
+		}
+
+		bool foundTabu() const
+		{
+			return foundTabu_;
+		}
+
+		const Move& tabuMove() const
+		{
+			return tabuMove_;
+		}
+
+		bool deletesContainer() const
+		{
+			return deletesContainer_;
+		}
+
+	private:
+		const Context& context_;
+		const ResultInterface& result_;
+		size_t** shortTermMemory_;
+
+		bool found_;
+		Move move_;
+		bool foundTabu_;
+		Move tabuMove_;
+		size_t minTabu_;
+		bool deletesContainer_;
+	};
+
     ResultInterface* tabuSearch(Context& context)
+	{
+		return tabuSearch(context, 200, 1.2);
+	}
+
+	// The tabu tenure is tenureFactor * sqrt(items * containers) steps.
+	ResultInterface* tabuSearch(Context& context, size_t maxSteps, double tenureFactor)
 	{
 		ResultInterface* currentResult = context.createRandomResult();
 
         size_t containersCount = currentResult->containersCount();
-        char** shortTermMemory = new char*[containersCount];
+        size_t** shortTermMemory = new size_t*[containersCount];
         for (size_t i = 0; i < containersCount; ++i) {
-            shortTermMemory[i] = new char[context.itemsCount()];
-            std::fill(shortTermMemory[i], shortTermMemory[i] + context.itemsCount(), 0);
+            shortTermMemory[i] = new size_t[context.classesCount()];
+            std::fill(shortTermMemory[i], shortTermMemory[i] + context.classesCount(), 0);
         }
 
-        char tabuTenure = static_cast<char>(std::sqrt(static_cast<double>(context.itemsCount() * containersCount)) * 1.2);
-        std::cout << "Tabu tenure: " << static_cast<int>(tabuTenure) << '\n';
+        size_t tabuTenure = static_cast<size_t>(std::sqrt(static_cast<double>(context.itemsCount() * containersCount)) * tenureFactor);
+        context.log() << "Tabu tenure: " << tabuTenure << '\n';
 
         ResultInterface* bestResult = currentResult->clone();
 
-		std::cout << "F: " << currentResult->toString() << '\n';
+		context.log() << "F: " << currentResult->toString() << '\n';
+
+		ContainersItems containersItems;
 
         size_t stepsCount = 0;
-        size_t maxSteps = 200;
 		while (maxSteps-- > 0) {
             stepsCount++;
 
-			ResultInterface::NeighbourRange* range = currentResult->neighbours();
-			ResultInterface* bestNeighbour = 0;
-            ResultInterface* neighbourWithMinTabu = 0;
-            int minTabu = 256;
-
-			while (!range->empty()) {
-				ResultInterface* neighbour = range->next();
-
-                int overallTabu = 0;
-                const std::vector< std::pair<size_t, size_t> >& notAllowedToSet = neighbour->notAllowedToSet();
-                for (std::vector< std::pair<size_t, size_t> >::const_iterator i = notAllowedToSet.begin(); i != notAllowedToSet.end(); ++i)
-                    if (shortTermMemory[i->first][i->second] > 0)
-                        overallTabu += shortTermMemory[i->first][i->second];
-
-                if (overallTabu > 0) {
-                    if (overallTabu < minTabu) {
-                        delete neighbourWithMinTabu;
-                        neighbourWithMinTabu = neighbour;
-                        neighbour = 0;
-                    } else {
-                        delete neighbour;
-                        neighbour = 0;
-                    }
-                }
+			collectContainersItems(*currentResult, containersItems);
+			TabuMove tabuMove(context, *currentResult, shortTermMemory);
+			Relocations::visit(context, *currentResult, containersItems, tabuMove);
+			if (!tabuMove.deletesContainer())
+				Exchanges::visit(context, *currentResult, containersItems, tabuMove);
 
-                if (neighbour) {
-				    if (bestNeighbour == 0 || context.less(*neighbour, *bestNeighbour)) {
-					    delete bestNeighbour;
-					    bestNeighbour = neighbour;
-				    } else {
-					    delete neighbour;
-				    }
+			if (tabuMove.found()) {
+				Move move = tabuMove.move();
+                if (context.less(*currentResult, emptyMove(move.kind), move)) {
+                    context.log() << "----------------------------------Bad result----------------------------------\n";
                 }
-			}
-			delete range;
 
-			if (bestNeighbour) {
-				std::cout << "BN: " << bestNeighbour->toString() << '\n';
+                size_t containersBefore = currentResult->containersCount();
+				currentResult->apply(move);
+				context.log() << "BN: " << currentResult->toString() << '\n';
 
-                size_t deletedContainer = 0;
-                if (bestNeighbour->deletedContainer(deletedContainer)) {
-                    char* temp = shortTermMemory[deletedContainer];
-                    for (size_t i = deletedContainer; i < containersCount; ++i)
-                        shortTermMemory[i] = shortTermMemory[i + 1];
-                    shortTermMemory[containersCount - 1] = temp;
+                if (move.deletedContainer) {
+                    std::swap(shortTermMemory[move.fromContainers[0]], shortTermMemory[containersBefore - 1]);
                 } else {
-                    const std::vector< std::pair<size_t, size_t> >& notAllowedToSet = bestNeighbour->notAllowedToSet();
-                    std::cout << "Changed items: ";
-                    for (std::vector< std::pair<size_t, size_t> >::const_iterator i = notAllowedToSet.begin(); i != notAllowedToSet.end(); ++i) {
-                        shortTermMemory[i->first][i->second] += tabuTenure + 1;
-                        std::cout << "(" << i->first << ", " << i->second << "), ";
+                    context.log() << "Changed items: ";
+                    for (size_t k = 0; k < move.length; ++k) {
+                        shortTermMemory[move.fromContainers[k]][context.itemClass(move.items[k])] += tabuTenure + 1;
+                        context.log() << "(" << move.fromContainers[k] << ", " << context.itemClass(move.items[k]) << "), ";
                     }
-                    std::cout << '\n';
-                }
-			}
-
-			if (bestNeighbour) {
-                if (context.less(*currentResult, *bestNeighbour)) {
-                    std::cout << "----------------------------------Bad result----------------------------------\n";
+                    context.log() << '\n';
                 }
 
-				ResultInterface* oldResult = currentResult;
-				currentResult = bestNeighbour->clone();
-
-                if (context.less(*bestNeighbour, *bestResult)) {
+                if (context.less(*currentResult, *bestResult)) {
                     delete bestResult;
-                    bestResult = bestNeighbour->clone();
+                    bestResult = currentResult->clone();
                 }
-
-				delete bestNeighbour;
-				delete oldResult;
 			} else {
-                if (neighbourWithMinTabu) {
-                    ResultInterface* oldResult = currentResult;
-				    currentResult = neighbourWithMinTabu->clone();
-                    delete neighbourWithMinTabu;
-				    delete oldResult;
+                if (tabuMove.foundTabu()) {
+				    Move move = tabuMove.tabuMove();
+                    size_t containersBefore = currentResult->containersCount();
+				    currentResult->apply(move);
+                    if (move.deletedContainer)
+                        std::swap(shortTermMemory[move.fromContainers[0]], shortTermMemory[containersBefore - 1]);
                 } else {
                     break;
                 }
 			}
 
             for (size_t i = 0; i < containersCount; ++i)
-                for (size_t j = 0; j < context.itemsCount(); ++j)
+                for (size_t j = 0; j < context.classesCount(); ++j)
                     if (shortTermMemory[i][j] > 0)
                         --shortTermMemory[i][j];
 		}
 
-        std::cout << "R: " << bestResult->toString() << '\n';
-        std::cout << "S: " << stepsCount << '\n';
+        context.log() << "R: " << bestResult->toString() << '\n';
+        context.log() << "S: " << stepsCount << '\n';
 
         delete currentResult;
+        for (size_t i = 0; i < containersCount; ++i)
+            delete[] shortTermMemory[i];
         delete[] shortTermMemory;
         return bestResult;
 	}
+
+	// Reactive tabu search. Moving a class out of a container forbids moving
+	// it back for "tenure" steps; the tenure grows whenever a packing is
+	// visited again and shrinks once no packing has repeated for longer than
+	// the average cycle. Revisits are looked up by the packing hash in a
+	// bounded visited cache. When packings keep repeating, or the best one has
+	// not improved for a while, the search restarts from one of the elite
+	// packings and diversifies it with relocations into the containers each
+	// class has entered least often. Tabu and frequency memories are flat
+	// containers * classes arrays indexed by container labels.
+	class ReactiveTabuMove
+	{
+	public:
+		ReactiveTabuMove(const Context& context, const ResultInterface& result, const std::vector<size_t>& tabuUntil, size_t step, bool aspiration) :
+			context_(context), result_(result), tabuUntil_(tabuUntil), step_(step), aspiration_(aspiration), found_(false)
+		{
+		}
+
+		bool operator()(const Move& move)
+		{
+			if (tabu(move) && !(aspiration_ && context_.improves(result_, move)))
+				return true;
+			if (!found_ || context_.less(result_, move, move_)) {
+				move_ = move;
+				found_ = true;
+			}
+			return true;
+		}
+
+		bool found() const
+		{
+			return found_;
+		}
+
+		const Move& move() const
+		{
+			return move_;
+		}
+
+	private:
+		bool tabu(const Move& move) const
+		{
+			for (size_t k = 0; k < move.length; ++k)
+				if (tabuUntil_[move.toContainers[k] * context_.classesCount() + context_.itemClass(move.items[k])] > step_)
+					return true;
+			return false;
+		}
+
+		const Context& context_;
+		const ResultInterface& result_;
+		const std::vector<size_t>& tabuUntil_;
+		size_t step_;
+		bool aspiration_;
+
+		bool found_;
+		Move move_;
+	};
+
+	static const size_t visitedCapacity = 1 << 16;
+	static const size_t eliteCount = 5;
+	static const size_t maxRepetitions = 3;
+	static const size_t chaoticRepetitions = 3;
+	static const double tenureIncrease = 1.1;
+	static const double tenureDecrease = 0.9;
+
+	static void swapRows(std::vector<size_t>& memory, size_t rowLength, size_t first, size_t second)
+	{
+		std::swap_ranges(memory.begin() + first * rowLength, memory.begin() + (first + 1) * rowLength, memory.begin() + second * rowLength);
+	}
+
+	static void diversify(const Context& context, ResultInterface& result, std::vector<size_t>& frequency, size_t movesCount)
+	{
+		size_t classesCount = context.classesCount();
+		for (size_t m = 0; m < movesCount; ++m) {
+			size_t item = context.random().below(context.itemsCount());
+			size_t from = result.containerOf(item);
+			size_t itemClass = context.itemClass(item);
+
+			size_t to = from;
+			for (size_t c = 0; c < result.containersCount(); ++c)
+				if (c != from && context.fits(result, item, c)
+					&& (to == from || frequency[c * classesCount + itemClass] < frequency[to * classesCount + itemClass]))
+					to = c;
+			if (to == from)
+				continue;
+
+			Move move = relocation(item, from, to);
+			context.score(result, move);
+			size_t containersBefore = result.containersCount();
+			result.apply(move);
+			++frequency[to * classesCount + itemClass];
+			if (move.deletedContainer)
+				swapRows(frequency, classesCount, from, containersBefore - 1);
+		}
+	}
+
+	// Everything reactiveTabuSearch carries from one step to the next, so a
+	// run can be checkpointed and resumed exactly where it stopped, together
+	// with the state of the context's random generator.
+	struct ReactiveTabuState
+	{
+		ReactiveTabuState(const Context& context, ResultInterface* initialResult, size_t maxSteps) : step(0), tenure(1.0),
+			averageCycle(static_cast<double>(initialResult->containersCount())), lastTenureChange(0), lastImprovement(0), chaoticCount(0), escapesCount(0),
+			stagnationSteps(10 * initialResult->containersCount()), tabuUntil(initialResult->containersCount() * context.classesCount(), 0),
+			frequency(initialResult->containersCount() * context.classesCount(), 0), visited(std::min(maxSteps, visitedCapacity)),
+			currentResult(initialResult), bestResult(initialResult->clone()), elite(1, initialResult->clone())
+		{
+		}
+
+		~ReactiveTabuState()
+		{
+			for (size_t i = 0; i < elite.size(); ++i)
+				delete elite[i];
+			delete currentResult;
+			delete bestResult;
+		}
+
+		void write(std::ostream& stream, const Context& context) const
+		{
+			writeNumber(stream, checkpointMagic);
+			writeNumber(stream, context.itemsCount());
+			writeNumber(stream, context.classesCount());
+			writeNumber(stream, context.random().state());
+
+			writeNumber(stream, step);
+			writeDouble(stream, tenure);
+			writeDouble(stream, averageCycle);
+			writeNumber(stream, lastTenureChange);
+			writeNumber(stream, lastImprovement);
+			writeNumber(stream, chaoticCount);
+			writeNumber(stream, escapesCount);
+			writeNumber(stream, stagnationSteps);
+			writeSizes(stream, tabuUntil);
+			writeSizes(stream, frequency);
+			visited.write(stream);
+
+			writeResult(stream, *currentResult);
+			writeResult(stream, *bestResult);
+			writeNumber(stream, elite.size());
+			for (size_t i = 0; i < elite.size(); ++i)
+				writeResult(stream, *elite[i]);
+		}
+
+		void read(std::istream& stream, const Context& context)
+		{
+			if (readNumber(stream) != checkpointMagic || readSize(stream) != context.itemsCount() || readSize(stream) != context.classesCount())
+				throw 1;
+			unsigned long long randomState = readNumber(stream);
+
+			step = readSize(stream);
+			tenure = readDouble(stream);
+			averageCycle = readDouble(stream);
+			lastTenureChange = readSize(stream);
+			lastImprovement = readSize(stream);
+			chaoticCount = readSize(stream);
+			escapesCount = readSize(stream);
+			stagnationSteps = readSize(stream);
+			readSizes(stream, tabuUntil, context.itemsCount() * context.classesCount());
+			readSizes(stream, frequency, context.itemsCount() * context.classesCount());
+			visited.read(stream);
+
+			// Released packings are cleared first, so that the destructor stays
+			// safe when a read below throws.
+			delete currentResult;
+			currentResult = 0;
+			currentResult = readResult(stream, context);
+			delete bestResult;
+			bestResult = 0;
+			bestResult = readResult(stream, context);
+			for (size_t i = 0; i < elite.size(); ++i)
+				delete elite[i];
+			elite.clear();
+			size_t eliteSize = readSize(stream);
+			if (eliteSize > eliteCount)
+				throw 1;
+			elite.resize(eliteSize, 0);
+			for (size_t i = 0; i < elite.size(); ++i)
+				elite[i] = readResult(stream, context);
+
+			if (tabuUntil.size() != frequency.size() || tabuUntil.size() < currentResult->containersCount() * context.classesCount() || elite.empty())
+				throw 1;
+			context.random().seed(randomState);
+		}
+
+		size_t step;
+		double tenure;
+		double averageCycle;
+		size_t lastTenureChange;
+		size_t lastImprovement;
+		size_t chaoticCount;
+		size_t escapesCount;
+		size_t stagnationSteps;
+		std::vector<size_t> tabuUntil;
+		std::vector<size_t> frequency;
+		VisitedCache visited;
+
+		ResultInterface* currentResult;
+		ResultInterface* bestResult;
+		std::deque<ResultInterface*> elite;
+
+	private:
+		static const unsigned long long checkpointMagic = 0x34435452;
+	};
+
+	// The checkpoint is written next to its final path and renamed over it,
+	// so a crash while writing leaves the previous checkpoint intact.
+	static void saveCheckpoint(const std::string& path, const Context& context, const ReactiveTabuState& state)
+	{
+		std::string temporaryPath = path + ".tmp";
+		std::ofstream file(temporaryPath.c_str(), std::ios::out | std::ios::binary);
+		if (!file.is_open())
+			throw 1;
+		state.write(file, context);
+		file.close();
+
+		std::remove(path.c_str());
+		if (std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+			throw 1;
+	}
+
+	static bool loadCheckpoint(const std::string& path, const Context& context, ReactiveTabuState& state)
+	{
+		std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+		if (!file.is_open())
+			return false;
+		state.read(file, context);
+		file.close();
+		return true;
+	}
+
+	ResultInterface* reactiveTabuSearch(Context& context, size_t maxSteps)
+	{
+		return reactiveTabuSearch(context, context.createRandomResult(), maxSteps);
+	}
+
+	static const double noDeadline = -1.0;
+
+	static ResultInterface* reactiveTabuSearch(Context& context, ResultInterface* initialResult, size_t maxSteps, double deadline, const char* checkpointPath,
+		size_t checkpointPeriod)
+	{
+		ReactiveTabuState state(context, initialResult, maxSteps);
+		if (checkpointPath != 0 && checkpointPeriod == 0)
+			throw 1;
+		if (checkpointPath != 0 && loadCheckpoint(checkpointPath, context, state))
+			context.log() << "Resumed at step " << state.step << '\n';
+
+		context.log() << "F: " << state.currentResult->toString() << '\n';
+
+		size_t classesCount = context.classesCount();
+		double maxTenure = static_cast<double>(context.itemsCount());
+		size_t checkpointStep = state.step;
+
+		ContainersItems containersItems;
+
+		while (state.step < maxSteps && state.bestResult->containersCount() > context.bestKnownNumberOfContainers()
+			&& (deadline == noDeadline || wallSeconds() < deadline)) {
+			if (checkpointPath != 0 && state.step % checkpointPeriod == 0 && state.step != checkpointStep) {
+				saveCheckpoint(checkpointPath, context, state);
+				checkpointStep = state.step;
+			}
+			size_t step = ++state.step;
+
+			bool escape = step - state.lastImprovement > state.stagnationSteps;
+			VisitedCache::Entry* visit = state.visited.find(state.currentResult->hash());
+			if (visit != 0) {
+				state.averageCycle = 0.1 * static_cast<double>(step - visit->lastStep) + 0.9 * state.averageCycle;
+				state.tenure = std::min(maxTenure, state.tenure * tenureIncrease + 1.0);
+				state.lastTenureChange = step;
+				if (visit->visitsCount >= maxRepetitions && ++state.chaoticCount > chaoticRepetitions)
+					escape = true;
+				visit->lastStep = step;
+				++visit->visitsCount;
+			} else {
+				if (static_cast<double>(step - state.lastTenureChange) > state.averageCycle) {
+					state.tenure = std::max(1.0, state.tenure * tenureDecrease);
+					state.lastTenureChange = step;
+				}
+				state.visited.insert(state.currentResult->hash(), step);
+			}
+
+			if (escape) {
+				++state.escapesCount;
+				delete state.currentResult;
+				state.currentResult = state.elite[context.random().below(state.elite.size())]->clone();
+				diversify(context, *state.currentResult, state.frequency, state.currentResult->containersCount());
+				std::fill(state.tabuUntil.begin(), state.tabuUntil.end(), 0);
+				state.visited.clear();
+				state.tenure = 1.0;
+				state.chaoticCount = 0;
+				state.lastImprovement = step;
+				continue;
+			}
+
+			ResultInterface& currentResult = *state.currentResult;
+			collectContainersItems(currentResult, containersItems);
+			ReactiveTabuMove tabuMove(context, currentResult, state.tabuUntil, step, !context.less(*state.bestResult, currentResult));
+			Relocations::visit(context, currentResult, containersItems, tabuMove);
+			Exchanges::visit(context, currentResult, containersItems, tabuMove);
+			if (!tabuMove.found())
+				continue;
+
+			Move move = tabuMove.move();
+			size_t containersBefore = currentResult.containersCount();
+			currentResult.apply(move);
+
+			for (size_t k = 0; k < move.length; ++k) {
+				size_t itemClass = context.itemClass(move.items[k]);
+				state.tabuUntil[move.fromContainers[k] * classesCount + itemClass] = step + static_cast<size_t>(state.tenure);
+				++state.frequency[move.toContainers[k] * classesCount + itemClass];
+			}
+			if (move.deletedContainer) {
+				swapRows(state.tabuUntil, classesCount, move.fromContainers[0], containersBefore - 1);
+				swapRows(state.frequency, classesCount, move.fromContainers[0], containersBefore - 1);
+			}
+
+			if (context.less(currentResult, *state.bestResult)) {
+				delete state.bestResult;
+				state.bestResult = currentResult.clone();
+				state.elite.push_back(currentResult.clone());
+				if (state.elite.size() > eliteCount) {
+					delete state.elite.front();
+					state.elite.pop_front();
+				}
+				state.lastImprovement = step;
+			}
+		}
+
+		if (checkpointPath != 0)
+			std::remove(checkpointPath);
+
+		context.log() << "R: " << state.bestResult->toString() << '\n';
+		context.log() << "S: " << state.step << ", escapes: " << state.escapesCount << '\n';
+
+		ResultInterface* bestResult = state.bestResult;
+		state.bestResult = 0;
+		return bestResult;
+	}
+
+	ResultInterface* reactiveTabuSearch(Context& context, ResultInterface* initialResult, size_t maxSteps, const char* checkpointPath, size_t checkpointPeriod)
+	{
+		return reactiveTabuSearch(context, initialResult, maxSteps, noDeadline, checkpointPath, checkpointPeriod);
+	}
+
+	ResultInterface* timedReactiveTabuSearch(Context& context, ResultInterface* initialResult, double deadline)
+	{
+		return reactiveTabuSearch(context, initialResult, static_cast<size_t>(-1), deadline, 0, 0);
+	}
+
+	ResultInterface* islandSearch(Context& context, const std::string& directory, size_t islandId, size_t islandsCount, size_t epochsCount, size_t epochSteps)
+	{
+		Island island(&context, directory, islandId, islandsCount);
+		ResultInterface* bestResult = context.createRandomResult();
+
+		size_t migrationsCount = 0;
+		for (size_t epoch = 0; epoch < epochsCount && bestResult->containersCount() > context.bestKnownNumberOfContainers(); ++epoch) {
+			ResultInterface* result = reactiveTabuSearch(context, bestResult->clone(), epochSteps);
+			if (context.less(*result, *bestResult)) {
+				delete bestResult;
+				bestResult = result;
+			} else {
+				delete result;
+			}
+			island.publish(*bestResult);
+
+			ResultInterface* migrant = island.migrant();
+			if (migrant != 0 && context.less(*migrant, *bestResult)) {
+				++migrationsCount;
+				delete bestResult;
+				bestResult = migrant;
+			} else {
+				delete migrant;
+			}
+		}
+		island.publish(*bestResult);
+
+		context.log() << "I: " << islandId << ", migrations: " << migrationsCount << '\n';
+		return bestResult;
+	}
+
+	// Walks from a packing towards a guide packing. Every step moves an item
+	// of a class its container holds more of than the matched guide container
+	// into a container holding fewer, by relocation when one fits and by an
+	// exchange with an item going the other way otherwise. Class counts per
+	// container are kept for both packings, so the distance left drops by
+	// one per relocated item without rematching.
+	class RelinkingPath
+	{
+	public:
+		RelinkingPath(const Context& context, ResultInterface& result, const ResultInterface& guide) : context_(context), result_(result),
+			classesCount_(context.classesCount())
+		{
+			distance_ = matchContainers(result_, guide, targets_);
+			counts_.assign(result_.containersCount() * classesCount_, 0);
+			wanted_.assign(guide.containersCount() * classesCount_, 0);
+			for (size_t i = 0; i < context_.itemsCount(); ++i) {
+				++counts_[result_.containerOf(i) * classesCount_ + context_.itemClass(i)];
+				++wanted_[guide.containerOf(i) * classesCount_ + context_.itemClass(i)];
+			}
+			collectContainersItems(result_, containersItems_);
+		}
+
+		size_t distance() const
+		{
+			return distance_;
+		}
+
+		bool step()
+		{
+			bool found = false;
+			Move best;
+			for (size_t exchanges = 0; exchanges < 2 && !found; ++exchanges)
+				for (size_t x = 0; x < containersItems_.size(); ++x)
+					for (size_t a = 0; a < containersItems_[x].size(); ++a) {
+						size_t first = containersItems_[x][a];
+						if (repeatsClass(context_, containersItems_[x], a, 0) || surplus(x, context_.itemClass(first)) <= 0)
+							continue;
+						for (size_t y = 0; y < containersItems_.size(); ++y) {
+							if (y == x || surplus(y, context_.itemClass(first)) >= 0)
+								continue;
+							if (exchanges == 0) {
+								Move move = relocation(first, x, y);
+								offer(move, found, best);
+								continue;
+							}
+							for (size_t c = 0; c < containersItems_[y].size(); ++c) {
+								size_t second = containersItems_[y][c];
+								if (repeatsClass(context_, containersItems_[y], c, 0) || surplus(y, context_.itemClass(second)) <= 0 || surplus(x, context_.itemClass(second)) >= 0)
+									continue;
+								Move move = exchange(first, x, second, y);
+								offer(move, found, best);
+							}
+						}
+					}
+			if (!found)
+				return false;
+
+			size_t containersBefore = result_.containersCount();
+			result_.apply(best);
+			updateContainersItems(context_, containersItems_, best);
+			for (size_t k = 0; k < best.length; ++k) {
+				--counts_[best.fromContainers[k] * classesCount_ + context_.itemClass(best.items[k])];
+				++counts_[best.toContainers[k] * classesCount_ + context_.itemClass(best.items[k])];
+			}
+			distance_ -= best.length;
+
+			if (best.deletedContainer) {
+				size_t last = containersBefore - 1;
+				std::swap_ranges(counts_.begin() + best.fromContainers[0] * classesCount_, counts_.begin() + (best.fromContainers[0] + 1) * classesCount_,
+					counts_.begin() + last * classesCount_);
+				counts_.resize(last * classesCount_);
+				std::swap(targets_[best.fromContainers[0]], targets_[last]);
+				targets_.pop_back();
+			}
+			return true;
+		}
+
+	private:
+		long surplus(size_t container, size_t itemClass) const
+		{
+			long wanted = targets_[container] == noTarget ? 0 : static_cast<long>(wanted_[targets_[container] * classesCount_ + itemClass]);
+			return static_cast<long>(counts_[container * classesCount_ + itemClass]) - wanted;
+		}
+
+		void offer(Move& move, bool& found, Move& best) const
+		{
+			context_.score(result_, move);
+			if (context_.fits(move) && (!found || context_.less(result_, move, best))) {
+				best = move;
+				found = true;
+			}
+		}
+
+		const Context& context_;
+		ResultInterface& result_;
+		size_t classesCount_;
+		size_t distance_;
+		std::vector<size_t> targets_;
+		std::vector<size_t> counts_;
+		std::vector<size_t> wanted_;
+		ContainersItems containersItems_;
+	};
+
+	// Best packing strictly between source and guide, or 0 when the path has
+	// no inner packing.
+	static ResultInterface* relink(const Context& context, const ResultInterface& source, const ResultInterface& guide)
+	{
+		ResultInterface* currentResult = source.clone();
+		RelinkingPath path(context, *currentResult, guide);
+
+		ResultInterface* bestResult = 0;
+		while (path.step() && path.distance() > 0) {
+			if (bestResult == 0 || context.less(*currentResult, *bestResult)) {
+				delete bestResult;
+				bestResult = currentResult->clone();
+			}
+		}
+		delete currentResult;
+		return bestResult;
+	}
+
+	static const size_t relinkingTabuSteps = 500;
+
+	ResultInterface* pathRelinking(Context& context, size_t startsCount, size_t eliteSize)
+	{
+		ElitePool pool(&context, eliteSize);
+		for (size_t i = 0; i < startsCount; ++i) {
+			ResultInterface* result = i % 2 == 0 ? hillClimbing(context, context.createRandomResult(), FirstImprovement) : reactiveTabuSearch(context, relinkingTabuSteps);
+			pool.offer(*result);
+			delete result;
+		}
+
+		context.log() << "F: " << pool.best().toString() << '\n';
+
+		std::vector<ResultInterface*> elite;
+		for (size_t i = 0; i < pool.size(); ++i)
+			elite.push_back(pool.at(i).clone());
+
+		size_t pathsCount = 0;
+		for (size_t a = 0; a < elite.size() && pool.best().containersCount() > context.bestKnownNumberOfContainers(); ++a) {
+			for (size_t b = 0; b < elite.size(); ++b) {
+				if (b == a)
+					continue;
+				++pathsCount;
+				ResultInterface* relinked = relink(context, *elite[a], *elite[b]);
+				if (relinked != 0) {
+					relinked = hillClimbing(context, relinked, FirstImprovement);
+					pool.offer(*relinked);
+					delete relinked;
+				}
+			}
+		}
+
+		for (size_t i = 0; i < elite.size(); ++i)
+			delete elite[i];
+
+		context.log() << "R: " << pool.best().toString() << '\n';
+		context.log() << "S: " << pathsCount << '\n';
+		return pool.best().clone();
+	}
+
+	static const size_t neighbourhoodsCount = 5;
+
+	static bool findBestMove(const Context& context, const ResultInterface& result, size_t neighbourhood, ContainersItems& containersItems, Move& move)
+	{
+		collectContainersItems(result, containersItems);
+
+		BestMove bestMove(context, result);
+		switch (neighbourhood) {
+		case 0:
+			Relocations::visit(context, result, containersItems, bestMove);
+			break;
+		case 1:
+			Exchanges::visit(context, result, containersItems, bestMove);
+			break;
+		case 2:
+			TwoOneExchanges::visit(context, result, containersItems, bestMove);
+			break;
+		case 3:
+			TwoTwoExchanges::visit(context, result, containersItems, bestMove);
+			break;
+		case 4:
+			EjectionChains::visit(context, result, containersItems, bestMove);
+			break;
+		}
+
+		if (bestMove.found())
+			move = bestMove.move();
+		return bestMove.found();
+	}
+
+	ResultInterface* variableNeighbourhoodDescent(Context& context)
+	{
+		ResultInterface* currentResult = context.createRandomResult();
+
+		context.log() << "F: " << currentResult->toString() << '\n';
+
+		ContainersItems containersItems;
+
+		size_t stepsCount = 0;
+		size_t neighbourhood = 0;
+		Move move;
+		while (neighbourhood < neighbourhoodsCount) {
+			if (findBestMove(context, *currentResult, neighbourhood, containersItems, move)) {
+				currentResult->apply(move);
+				neighbourhood = 0;
+				stepsCount++;
+			} else {
+				++neighbourhood;
+			}
+		}
+
+		context.log() << "R: " << currentResult->toString() << '\n';
+		context.log() << "S: " << stepsCount << '\n';
+		return currentResult;
+	}
+
+	class MoreSlack
+	{
+	public:
+		MoreSlack(const ResultInterface& result) : weights_(result.containersWeights())
+		{
+		}
+
+		bool operator()(size_t first, size_t second) const
+		{
+			return weights_[first] < weights_[second];
+		}
+
+	private:
+		const double* weights_;
+	};
+
+	class HeavierItem
+	{
+	public:
+		HeavierItem(const Context& context) : context_(context)
+		{
+		}
+
+		bool operator()(size_t first, size_t second) const
+		{
+			return context_.itemWeight(first) > context_.itemWeight(second);
+		}
+
+	private:
+		const Context& context_;
+	};
+
+	static bool integralWeights(const Context& context)
+	{
+		if (context.containerCapacity() != std::floor(context.containerCapacity()))
+			return false;
+		for (size_t i = 0; i < context.itemsCount(); ++i)
+			if (context.itemWeight(i) != std::floor(context.itemWeight(i)))
+				return false;
+		return true;
+	}
+
+	static const size_t noContainer = static_cast<size_t>(-1);
+
+	// Ruins a few containers and packs their items again by best fit
+	// decreasing, or by repeated subset sums when that opens fewer
+	// containers. The repair is planned on container weights alone and then
+	// carried out on the current Result as relocations, which are undone
+	// again when the packing gets worse. A reopened container is mapped to
+	// a ruined one that still holds items, so containers only ever empty
+	// (and get deleted by Result::apply) once nothing more moves into them.
+	class RuinAndRecreate
+	{
+	public:
+		RuinAndRecreate(const Context& context, ResultInterface& result, size_t ruinedCount, SubsetSum* subsetSum) : context_(context), result_(result),
+			ruinedCount_(ruinedCount), subsetSum_(subsetSum)
+		{
+			collectContainersItems(result_, containersItems_);
+		}
+
+		void step()
+		{
+			ruin();
+			size_t newCount = bestFitDecreasing();
+			if (subsetSum_ && newCount > 1)
+				newCount = subsetSumFill(newCount);
+			if (newCount > ruinedContainers_.size())
+				return;
+
+			moves_.clear();
+			if (!recreate(newCount) || context_.less(oldWeights_, newWeights())) {
+				for (size_t m = moves_.size(); m > 0; --m)
+					result_.undo(moves_[m - 1]);
+				return;
+			}
+			for (size_t m = 0; m < moves_.size(); ++m)
+				updateContainersItems(context_, containersItems_, moves_[m]);
+		}
+
+	private:
+		void ruin()
+		{
+			size_t containersCount = result_.containersCount();
+			bySlack_.resize(containersCount);
+			for (size_t c = 0; c < containersCount; ++c)
+				bySlack_[c] = c;
+			std::sort(bySlack_.begin(), bySlack_.end(), MoreSlack(result_));
+
+			size_t poolSize = std::min(containersCount, 2 * ruinedCount_);
+			for (size_t c = 1; c < poolSize; ++c)
+				std::swap(bySlack_[c], bySlack_[c + context_.random().below(poolSize - c)]);
+			ruined_.assign(containersCount, false);
+			for (size_t c = 0; c < ruinedCount_ && c < containersCount; ++c)
+				ruined_[bySlack_[c]] = true;
+			for (size_t c = 0; c < ruinedCount_; ++c)
+				ruined_[context_.random().below(containersCount)] = true;
+
+			ruinedContainers_.clear();
+			ruinedItems_.clear();
+			for (size_t c = 0; c < containersCount; ++c) {
+				if (ruined_[c]) {
+					ruinedContainers_.push_back(c);
+					ruinedItems_.insert(ruinedItems_.end(), containersItems_[c].begin(), containersItems_[c].end());
+				}
+			}
+			std::sort(ruinedItems_.begin(), ruinedItems_.end(), HeavierItem(context_));
+		}
+
+		// Plans every ruined item into a kept container or into the k-th new
+		// one, as containersCount + k, and returns the number of new ones.
+		size_t bestFitDecreasing()
+		{
+			size_t containersCount = result_.containersCount();
+			weights_.assign(result_.containersWeights(), result_.containersWeights() + containersCount);
+			for (size_t r = 0; r < ruinedContainers_.size(); ++r)
+				weights_[ruinedContainers_[r]] = 0.0;
+
+			targets_.resize(ruinedItems_.size());
+			for (size_t i = 0; i < ruinedItems_.size(); ++i) {
+				double weight = context_.itemWeight(ruinedItems_[i]);
+				size_t bestContainer = noContainer;
+				for (size_t c = 0; c < weights_.size(); ++c) {
+					if (c < containersCount && ruined_[c])
+						continue;
+					if (context_.fits(weights_[c] + weight) && (bestContainer == noContainer || weights_[c] > weights_[bestContainer]))
+						bestContainer = c;
+				}
+				if (bestContainer == noContainer) {
+					bestContainer = weights_.size();
+					weights_.push_back(0.0);
+				}
+				weights_[bestContainer] += weight;
+				targets_[i] = bestContainer;
+			}
+			return weights_.size() - containersCount;
+		}
+
+		// Packs the items best fit left for new containers again, one
+		// container per subset sum; weightless items join the first one,
+		// since a subset sum never needs them.
+		size_t subsetSumFill(size_t newCount)
+		{
+			size_t containersCount = result_.containersCount();
+			leftovers_.clear();
+			for (size_t i = 0; i < ruinedItems_.size(); ++i)
+				if (targets_[i] >= containersCount && context_.itemWeight(ruinedItems_[i]) > 0.0)
+					leftovers_.push_back(i);
+
+			fillTargets_.assign(ruinedItems_.size(), containersCount);
+			size_t filledCount = 0;
+			while (!leftovers_.empty() && filledCount < newCount) {
+				subsetWeights_.resize(leftovers_.size());
+				for (size_t i = 0; i < leftovers_.size(); ++i)
+					subsetWeights_[i] = static_cast<size_t>(context_.itemWeight(ruinedItems_[leftovers_[i]]));
+				subsetSum_->solve(subsetWeights_, chosen_);
+
+				remaining_.clear();
+				for (size_t i = 0; i < leftovers_.size(); ++i) {
+					if (chosen_[i])
+						fillTargets_[leftovers_[i]] = containersCount + filledCount;
+					else
+						remaining_.push_back(leftovers_[i]);
+				}
+				leftovers_.swap(remaining_);
+				++filledCount;
+			}
+			if (!leftovers_.empty() || filledCount >= newCount)
+				return newCount;
+
+			for (size_t i = 0; i < ruinedItems_.size(); ++i)
+				if (targets_[i] >= containersCount)
+					targets_[i] = fillTargets_[i];
+			return std::max<size_t>(filledCount, 1);
+		}
+
+		// Carries the plan out. Kept containers only gain items, a reopened
+		// container keeps the item it was opened with, and every other ruined
+		// container only loses items, so the ones deleted on the way are
+		// never targets.
+		bool recreate(size_t newCount)
+		{
+			size_t containersCount = result_.containersCount();
+			positions_.resize(containersCount);
+			owners_.resize(containersCount);
+			sizes_.resize(containersCount);
+			for (size_t c = 0; c < containersCount; ++c) {
+				positions_[c] = c;
+				owners_[c] = c;
+				sizes_[c] = containersItems_[c].size();
+			}
+			reopened_.assign(newCount, noContainer);
+			opened_.assign(containersCount, false);
+			changed_.assign(containersCount, false);
+
+			touched_.clear();
+			oldWeights_.clear();
+			for (size_t r = 0; r < ruinedContainers_.size(); ++r) {
+				touched_.push_back(ruinedContainers_[r]);
+				oldWeights_.push_back(result_.containersWeights()[ruinedContainers_[r]]);
+			}
+
+			for (size_t i = 0; i < ruinedItems_.size(); ++i) {
+				size_t item = ruinedItems_[i];
+				size_t source = owners_[result_.containerOf(item)];
+				size_t target = targets_[i];
+				if (target >= containersCount) {
+					size_t& reopened = reopened_[target - containersCount];
+					if (reopened == noContainer) {
+						if (!opened_[source]) {
+							reopened = source;
+						} else {
+							for (size_t r = 0; r < ruinedContainers_.size() && reopened == noContainer; ++r)
+								if (!opened_[ruinedContainers_[r]] && sizes_[ruinedContainers_[r]] > 0)
+									reopened = ruinedContainers_[r];
+							if (reopened == noContainer)
+								return false;
+						}
+						opened_[reopened] = true;
+					}
+					target = reopened;
+				} else if (!changed_[target]) {
+					changed_[target] = true;
+					touched_.push_back(target);
+					oldWeights_.push_back(result_.containersWeights()[positions_[target]]);
+				}
+				if (target != source)
+					relocate(item, source, target);
+			}
+			return true;
+		}
+
+		void relocate(size_t item, size_t source, size_t target)
+		{
+			Move move = relocation(item, positions_[source], positions_[target]);
+			result_.apply(move);
+			moves_.push_back(move);
+			--sizes_[source];
+			++sizes_[target];
+			if (move.deletedContainer) {
+				size_t last = result_.containersCount();
+				owners_[positions_[source]] = owners_[last];
+				positions_[owners_[last]] = positions_[source];
+				positions_[source] = noContainer;
+			}
+		}
+
+		const std::vector<double>& newWeights()
+		{
+			newWeights_.clear();
+			for (size_t t = 0; t < touched_.size(); ++t)
+				newWeights_.push_back(positions_[touched_[t]] == noContainer ? 0.0 : result_.containersWeights()[positions_[touched_[t]]]);
+			return newWeights_;
+		}
+
+		const Context& context_;
+		ResultInterface& result_;
+		size_t ruinedCount_;
+		SubsetSum* subsetSum_;
+		ContainersItems containersItems_;
+
+		std::vector<size_t> bySlack_;
+		std::vector<bool> ruined_;
+		std::vector<size_t> ruinedContainers_;
+		std::vector<size_t> ruinedItems_;
+		std::vector<double> weights_;
+		std::vector<size_t> targets_;
+		std::vector<size_t> leftovers_;
+		std::vector<size_t> remaining_;
+		std::vector<size_t> fillTargets_;
+		std::vector<size_t> subsetWeights_;
+		std::vector<bool> chosen_;
+		std::vector<size_t> positions_;
+		std::vector<size_t> owners_;
+		std::vector<size_t> sizes_;
+		std::vector<size_t> reopened_;
+		std::vector<bool> opened_;
+		std::vector<bool> changed_;
+		std::vector<size_t> touched_;
+		std::vector<double> oldWeights_;
+		std::vector<double> newWeights_;
+		std::vector<Move> moves_;
+	};
+
+	ResultInterface* largeNeighbourhoodSearch(Context& context, size_t ruinedCount, size_t maxSteps)
+	{
+		if (!context.weightOnly())
+			throw 1;
+
+		ResultInterface* currentResult = context.createRandomResult();
+
+		context.log() << "F: " << currentResult->toString() << '\n';
+
+		SubsetSum* subsetSum = integralWeights(context) ? new SubsetSum(static_cast<size_t>(context.containerCapacity())) : 0;
+		RuinAndRecreate ruinAndRecreate(context, *currentResult, ruinedCount, subsetSum);
+
+		size_t stepsCount = 0;
+		while (stepsCount < maxSteps && currentResult->containersCount() > context.bestKnownNumberOfContainers()) {
+			stepsCount++;
+			ruinAndRecreate.step();
+		}
+		delete subsetSum;
+
+		context.log() << "R: " << currentResult->toString() << '\n';
+		context.log() << "S: " << stepsCount << '\n';
+		return currentResult;
+	}
+
+	// One item, or two of the same container, that an exchange moves.
+	struct ItemsGroup
+	{
+		double weight;
+		size_t first;
+		size_t second;
+
+		bool operator<(const ItemsGroup& other) const
+		{
+			return weight < other.weight;
+		}
+	};
+
+	static const size_t noItem = static_cast<size_t>(-1);
+	// Containers with more items exchange them one at a time only, so the
+	// pairs stay few.
+	static const size_t maxPairedItems = 16;
+
+	static void collectGroups(const Context& context, const std::vector<size_t>& items, std::vector<ItemsGroup>& groups)
+	{
+		groups.clear();
+		for (size_t i = 0; i < items.size(); ++i) {
+			ItemsGroup group = { context.itemWeight(items[i]), items[i], noItem };
+			groups.push_back(group);
+			if (items.size() > maxPairedItems)
+				continue;
+			for (size_t j = i + 1; j < items.size(); ++j) {
+				ItemsGroup pair = { context.itemWeight(items[i]) + context.itemWeight(items[j]), items[i], items[j] };
+				groups.push_back(pair);
+			}
+		}
+	}
+
+	// Swaps the groups of container and other, first pairing their first
+	// items and then moving or swapping what is left.
+	static void exchangeGroups(Packing& packing, const ItemsGroup& group, size_t container, const ItemsGroup& otherGroup, size_t other)
+	{
+		packing.swap(group.first, otherGroup.first);
+		if (group.second != noItem && otherGroup.second != noItem)
+			packing.swap(group.second, otherGroup.second);
+		else if (group.second != noItem)
+			packing.move(group.second, other);
+		else if (otherGroup.second != noItem)
+			packing.move(otherGroup.second, container);
+	}
+
+	// Moves weight out of container into a fuller one: one of its items
+	// into the best fitting container, or else the 1-1, 1-2, 2-1 or 2-2
+	// exchange with the largest gain against the containers just fuller
+	// than it and a few random ones. Every such move raises the sum of
+	// squared loads, so repeating it ends.
+	static bool drainContainer(Packing& packing, size_t container, size_t candidatesCount)
+	{
+		const Context* context = packing.context();
+		double slack = context->containerCapacity() - packing.containerWeight(container);
+		const std::vector<size_t>& items = packing.containerItems(container);
+
+		for (size_t i = 0; i < items.size(); ++i) {
+			size_t toContainer = packing.bestFit(context->itemWeight(items[i]), slack, container);
+			if (toContainer != Packing::noContainer) {
+				packing.move(items[i], toContainer);
+				return true;
+			}
+		}
+
+		std::vector<size_t> candidates;
+		packing.containersBelowResidual(slack, candidatesCount, container, candidates);
+		for (size_t s = 0; s < candidatesCount; ++s) {
+			size_t other = packing.containerOf(context->random().below(context->itemsCount()));
+			if (other != container && context->containerCapacity() - packing.containerWeight(other) <= slack)
+				candidates.push_back(other);
+		}
+
+		std::vector<ItemsGroup> groups, otherGroups;
+		collectGroups(*context, items, groups);
+
+		double bestGain = capacityTolerance;
+		size_t bestOther = Packing::noContainer;
+		ItemsGroup bestGroup = ItemsGroup(), bestOtherGroup = ItemsGroup();
+		for (size_t c = 0; c < candidates.size(); ++c) {
+			double residual = context->containerCapacity() - packing.containerWeight(candidates[c]);
+			collectGroups(*context, packing.containerItems(candidates[c]), otherGroups);
+			std::sort(otherGroups.begin(), otherGroups.end());
+			for (size_t g = 0; g < groups.size(); ++g) {
+				// The lightest group of the other container that still leaves
+				// it within capacity gives the largest gain.
+				ItemsGroup bound = { groups[g].weight - residual - capacityTolerance, noItem, noItem };
+				std::vector<ItemsGroup>::const_iterator lightest = std::lower_bound(otherGroups.begin(), otherGroups.end(), bound);
+				if (lightest != otherGroups.end() && groups[g].weight - lightest->weight > bestGain) {
+					bestGain = groups[g].weight - lightest->weight;
+					bestOther = candidates[c];
+					bestGroup = groups[g];
+					bestOtherGroup = *lightest;
+				}
+			}
+		}
+
+		if (bestOther == Packing::noContainer)
+			return false;
+		exchangeGroups(packing, bestGroup, container, bestOtherGroup, bestOther);
+		return true;
+	}
+
+	// Sweeps the containers from the emptiest, draining each while that
+	// succeeds, until a whole sweep closes no container. Later sweeps only
+	// find the few moves the random candidates turn up.
+	static Packing* largeInstanceSearch(Context& context, size_t candidatesCount, size_t maxSteps, double deadline)
+	{
+		if (!context.weightOnly())
+			throw 1;
+
+		Packing* packing = new Packing(&context);
+		packing->bestFitDecreasing();
+
+		context.log() << "F: " << packing->toString() << '\n';
+
+		size_t stepsCount = 0;
+		std::vector<size_t> order;
+		size_t containersBefore = static_cast<size_t>(-1);
+		bool stopped = packing->containersCount() <= context.bestKnownNumberOfContainers();
+		while (packing->containersCount() < containersBefore && !stopped) {
+			containersBefore = packing->containersCount();
+
+			bool improved = true;
+			while (improved && !stopped) {
+				packing->emptiestContainers(candidatesCount, order);
+				improved = false;
+				for (size_t i = 0; i < order.size() && !improved; ++i)
+					improved = drainContainer(*packing, order[i], candidatesCount);
+				if (improved)
+					stepsCount++;
+				stopped = stepsCount >= maxSteps || packing->containersCount() <= context.bestKnownNumberOfContainers()
+					|| (deadline != noDeadline && wallSeconds() >= deadline);
+			}
+
+			packing->emptiestContainers(packing->containersCount(), order);
+			for (size_t i = 0; i < order.size() && !stopped; ++i) {
+				while (stepsCount < maxSteps && !packing->containerItems(order[i]).empty() && drainContainer(*packing, order[i], candidatesCount))
+					stepsCount++;
+				stopped = stepsCount >= maxSteps || packing->containersCount() <= context.bestKnownNumberOfContainers()
+					|| (deadline != noDeadline && wallSeconds() >= deadline);
+			}
+		}
+
+		context.log() << "R: " << packing->toString() << '\n';
+		context.log() << "S: " << stepsCount << '\n';
+		return packing;
+	}
+
+	Packing* largeInstanceSearch(Context& context, size_t candidatesCount, size_t maxSteps)
+	{
+		return largeInstanceSearch(context, candidatesCount, maxSteps, noDeadline);
+	}
+
+	Packing* timedLargeInstanceSearch(Context& context, double deadline)
+	{
+		return largeInstanceSearch(context, 32, static_cast<size_t>(-1), deadline);
+	}
 }
\ No newline at end of file
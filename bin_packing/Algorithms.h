@@ -1,8 +1,29 @@
+#include <cstddef>
+#include <string>
+
 namespace bin_packing
 {
 	class ResultInterface;
 	class Context;
+	class Packing;
+
+	enum ClimbingStrategy { BestImprovement, FirstImprovement, DontLookBits };
 
-	ResultInterface* hillClimbing(Context& context);
+	ResultInterface* hillClimbing(Context& context, ClimbingStrategy strategy = BestImprovement);
+	ResultInterface* hillClimbing(Context& context, ResultInterface* initialResult, ClimbingStrategy strategy = BestImprovement);
     ResultInterface* tabuSearch(Context& context);
+	ResultInterface* tabuSearch(Context& context, size_t maxSteps, double tenureFactor);
+	ResultInterface* reactiveTabuSearch(Context& context, size_t maxSteps = 2000);
+	ResultInterface* reactiveTabuSearch(Context& context, ResultInterface* initialResult, size_t maxSteps = 2000, const char* checkpointPath = 0, size_t checkpointPeriod = 100);
+	// Runs until wallSeconds() passes the deadline instead of for a number
+	// of steps.
+	ResultInterface* timedReactiveTabuSearch(Context& context, ResultInterface* initialResult, double deadline);
+	ResultInterface* islandSearch(Context& context, const std::string& directory, size_t islandId, size_t islandsCount, size_t epochsCount = 20, size_t epochSteps = 500);
+	ResultInterface* pathRelinking(Context& context, size_t startsCount = 8, size_t eliteSize = 5);
+	ResultInterface* variableNeighbourhoodDescent(Context& context);
+	ResultInterface* largeNeighbourhoodSearch(Context& context, size_t ruinedCount = 3, size_t maxSteps = 1000);
+
+	Packing* largeInstanceSearch(Context& context, size_t candidatesCount = 32, size_t maxSteps = static_cast<size_t>(-1));
+	// Also stops once wallSeconds() passes the deadline.
+	Packing* timedLargeInstanceSearch(Context& context, double deadline);
 }
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "ConflictGraph.h"
+
+#include <climits>
+
+namespace bin_packing
+{
+	static const size_t wordBits = sizeof(ConflictWord) * CHAR_BIT;
+
+	static ConflictWord bit(size_t item)
+	{
+		return static_cast<ConflictWord>(1) << (item % wordBits);
+	}
+
+	ConflictGraph::ConflictGraph(size_t itemsCount) : itemsCount_(itemsCount), wordsCount_(itemsCount / wordBits + 1)
+	{
+	}
+
+	void ConflictGraph::add(size_t first, size_t second)
+	{
+		if (first >= itemsCount_ || second >= itemsCount_ || first == second)
+			throw 1;
+		if (rows_.empty()) {
+			rows_.assign(itemsCount_ * wordsCount_, 0);
+			degrees_.assign(itemsCount_, 0);
+		}
+		if (conflicts(first, second))
+			return;
+		insert(&rows_[first * wordsCount_], second);
+		insert(&rows_[second * wordsCount_], first);
+		++degrees_[first];
+		++degrees_[second];
+	}
+
+	size_t ConflictGraph::itemsCount() const
+	{
+		return itemsCount_;
+	}
+
+	bool ConflictGraph::empty() const
+	{
+		return rows_.empty();
+	}
+
+	bool ConflictGraph::conflicts(size_t first, size_t second) const
+	{
+		return !rows_.empty() && (rows_[first * wordsCount_ + second / wordBits] & bit(second)) != 0;
+	}
+
+	bool ConflictGraph::hasConflicts(size_t item) const
+	{
+		return !rows_.empty() && degrees_[item] != 0;
+	}
+
+	size_t ConflictGraph::wordsCount() const
+	{
+		return wordsCount_;
+	}
+
+	bool ConflictGraph::conflictsWith(size_t item, const ConflictWord* occupancy, const size_t* excluded, size_t excludedCount) const
+	{
+		if (!hasConflicts(item))
+			return false;
+		const ConflictWord* row = &rows_[item * wordsCount_];
+		for (size_t w = 0; w < wordsCount_; ++w) {
+			ConflictWord common = row[w] & occupancy[w];
+			if (common == 0)
+				continue;
+			for (size_t e = 0; e < excludedCount; ++e)
+				if (excluded[e] / wordBits == w)
+					common &= ~bit(excluded[e]);
+			if (common != 0)
+				return true;
+		}
+		return false;
+	}
+
+	void ConflictGraph::insert(ConflictWord* occupancy, size_t item)
+	{
+		occupancy[item / wordBits] |= bit(item);
+	}
+
+	void ConflictGraph::remove(ConflictWord* occupancy, size_t item)
+	{
+		occupancy[item / wordBits] &= ~bit(item);
+	}
+}
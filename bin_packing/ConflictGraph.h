@@ -0,0 +1,44 @@
+#ifndef CONFLICT_GRAPH_H
+#define CONFLICT_GRAPH_H
+
+#include <cstddef>
+#include <vector>
+
+namespace bin_packing
+{
+	typedef unsigned long ConflictWord;
+
+	// Pairs of items that must not share a container, one bitset row per
+	// item. A container keeps an occupancy bitset of its items with the same
+	// layout, so whether an item conflicts with a container is one AND per
+	// machine word instead of a scan over the container's items. The rows
+	// are only allocated by the first conflict, so instances without
+	// conflicts pay nothing for them.
+	class ConflictGraph
+	{
+	public:
+		ConflictGraph(size_t itemsCount);
+
+		void add(size_t first, size_t second);
+		size_t itemsCount() const;
+		bool empty() const;
+		bool conflicts(size_t first, size_t second) const;
+		bool hasConflicts(size_t item) const;
+
+		size_t wordsCount() const;
+		// Does the item conflict with any item of the occupancy bitset other
+		// than the excluded ones, which are about to leave the container?
+		bool conflictsWith(size_t item, const ConflictWord* occupancy, const size_t* excluded = 0, size_t excludedCount = 0) const;
+
+		static void insert(ConflictWord* occupancy, size_t item);
+		static void remove(ConflictWord* occupancy, size_t item);
+
+	private:
+		size_t itemsCount_;
+		size_t wordsCount_;
+		std::vector<ConflictWord> rows_;
+		std::vector<size_t> degrees_;
+	};
+}
+
+#endif // CONFLICT_GRAPH_H
@@ -2,17 +2,105 @@
 #include "ResultInterface.h"
 #include "Result.h"
 #include "Clone.h"
+#include "Move.h"
+#include "Resources.h"
 
 #include "RandomGenerators.h"
 
 #include <algorithm>
 #include <functional>
+#include <iostream>
 
 namespace bin_packing
 {
+	// Items of a weight class are interchangeable, so for vector packing
+	// equal weights are not enough and the resource rows have to match too,
+	// and an item with conflicts is in a class of its own.
+	class LighterItem
+	{
+	public:
+		LighterItem(const double* items, const double* resources, size_t stride, const ConflictGraph& conflicts) : items_(items), resources_(resources), stride_(stride),
+			conflicts_(conflicts)
+		{
+		}
+
+		bool operator()(size_t first, size_t second) const
+		{
+			if (items_[first] != items_[second])
+				return items_[first] < items_[second];
+			for (size_t k = 0; k < stride_; ++k)
+				if (resources_[first * stride_ + k] != resources_[second * stride_ + k])
+					return resources_[first * stride_ + k] < resources_[second * stride_ + k];
+			return first < second;
+		}
+
+		bool sameClass(size_t first, size_t second) const
+		{
+			return items_[first] == items_[second] && std::equal(resources_ + first * stride_, resources_ + (first + 1) * stride_, resources_ + second * stride_)
+				&& !conflicts_.hasConflicts(first) && !conflicts_.hasConflicts(second);
+		}
+
+	private:
+		const double* items_;
+		const double* resources_;
+		size_t stride_;
+		const ConflictGraph& conflicts_;
+	};
+
+	static const size_t maxDimensions = 16;
+
 	Context::Context(double containerCapacity, size_t itemsCount, double* items, size_t bestKnownNumberOfContainers) : containerCapacity_(containerCapacity),
-		itemsCount_(itemsCount), items_(items), bestKnownNumberOfContainers_(bestKnownNumberOfContainers)
+		itemsCount_(itemsCount), items_(items), bestKnownNumberOfContainers_(bestKnownNumberOfContainers),
+		itemsClasses_(itemsCount), itemsByClass_(itemsCount), classesCount_(0), startGenerator_(RandomFirstFit),
+		dimensionsCount_(1), resourcesStride_(0), conflicts_(itemsCount), log_(&std::cout)
+	{
+		initializeClasses();
+	}
+
+	Context::Context(size_t dimensionsCount, const double* capacities, size_t itemsCount, const double* resources, size_t bestKnownNumberOfContainers) :
+		containerCapacity_(static_cast<double>(dimensionsCount)), itemsCount_(itemsCount), items_(0), bestKnownNumberOfContainers_(bestKnownNumberOfContainers),
+		itemsClasses_(itemsCount), itemsByClass_(itemsCount), classesCount_(0), startGenerator_(RandomFirstFit),
+		dimensionsCount_(dimensionsCount), resourcesStride_(bin_packing::resourcesStride(dimensionsCount)),
+		resources_(itemsCount * resourcesStride_, 0.0), relativeWeights_(itemsCount, 0.0), conflicts_(itemsCount), log_(&std::cout)
+	{
+		if (dimensionsCount == 0 || dimensionsCount > maxDimensions || itemsCount == 0)
+			throw 1;
+		for (size_t k = 0; k < dimensionsCount; ++k)
+			if (capacities[k] <= 0.0)
+				throw 1;
+
+		for (size_t i = 0; i < itemsCount; ++i) {
+			for (size_t k = 0; k < dimensionsCount; ++k) {
+				double resource = resources[i * dimensionsCount + k] / capacities[k];
+				if (resource < 0.0 || resource > 1.0 + resourceTolerance)
+					throw 1;
+				resources_[i * resourcesStride_ + k] = resource;
+				relativeWeights_[i] += resource;
+			}
+		}
+		items_ = &relativeWeights_[0];
+		initializeClasses();
+	}
+
+	void Context::initializeClasses()
 	{
+		const double* resources = resources_.empty() ? 0 : &resources_[0];
+		LighterItem lighterItem(items_, resources, resourcesStride_, conflicts_);
+		for (size_t i = 0; i < itemsCount_; ++i)
+			itemsByClass_[i] = i;
+		std::sort(itemsByClass_.begin(), itemsByClass_.end(), lighterItem);
+
+		classesCount_ = 0;
+		for (size_t i = 0; i < itemsCount_; ++i) {
+			if (i == 0 || !lighterItem.sameClass(itemsByClass_[i], itemsByClass_[i - 1]))
+				++classesCount_;
+			itemsClasses_[itemsByClass_[i]] = classesCount_ - 1;
+		}
+
+		classesKeys_.resize(classesCount_);
+		PackingHash seed = 0;
+		for (size_t k = 0; k < classesCount_; ++k)
+			classesKeys_[k] = seed = mixBits(seed);
 	}
 
 	bool Context::less(const ResultInterface& r1, const ResultInterface& r2) const
@@ -51,17 +139,205 @@ namespace bin_packing
 
 	}
 
+	static const double emptyWeight = 1e-9;
+
+	void Context::score(const ResultInterface& origin, Move& move) const
+	{
+		move.changedCount = 0;
+		for (size_t k = 0; k < move.length; ++k) {
+			size_t ends[2] = { move.fromContainers[k], move.toContainers[k] };
+			for (size_t e = 0; e < 2; ++e) {
+				size_t c = 0;
+				while (c < move.changedCount && move.changedContainers[c] != ends[e])
+					++c;
+				if (c == move.changedCount) {
+					move.changedContainers[c] = ends[e];
+					move.changedWeights[c] = origin.containersWeights()[ends[e]];
+					++move.changedCount;
+				}
+				if (e == 0)
+					move.changedWeights[c] -= items_[move.items[k]];
+				else
+					move.changedWeights[c] += items_[move.items[k]];
+			}
+		}
+		move.overloaded = dimensionsCount_ > 1 && !resourcesFit(origin, move);
+		move.conflicting = !conflicts_.empty() && !conflictFree(origin, move);
+	}
+
+	bool Context::resourcesFit(const ResultInterface& origin, const Move& move) const
+	{
+		double load[maxDimensions];
+		for (size_t c = 0; c < move.changedCount; ++c) {
+			size_t container = move.changedContainers[c];
+			const double* originLoad = origin.containersResources() + container * resourcesStride_;
+			std::copy(originLoad, originLoad + resourcesStride_, load);
+			for (size_t k = 0; k < move.length; ++k) {
+				if (move.fromContainers[k] == container)
+					subtractRow(load, itemResources(move.items[k]), resourcesStride_);
+				else if (move.toContainers[k] == container)
+					addRow(load, itemResources(move.items[k]), resourcesStride_);
+			}
+			if (!rowFits(load, resourcesStride_))
+				return false;
+		}
+		return true;
+	}
+
+	// Every item that enters a container is tested against the container's
+	// occupancy without the items that leave it in the same move, and
+	// against the items that enter it before.
+	bool Context::conflictFree(const ResultInterface& origin, const Move& move) const
+	{
+		size_t wordsCount = conflicts_.wordsCount();
+		size_t leaving[Move::maxLength];
+		for (size_t k = 0; k < move.length; ++k) {
+			size_t item = move.items[k];
+			size_t container = move.toContainers[k];
+			if (!conflicts_.hasConflicts(item))
+				continue;
+
+			size_t leavingCount = 0;
+			for (size_t j = 0; j < move.length; ++j)
+				if (move.fromContainers[j] == container)
+					leaving[leavingCount++] = move.items[j];
+			if (conflicts_.conflictsWith(item, origin.containersOccupancy() + container * wordsCount, leaving, leavingCount))
+				return false;
+			for (size_t j = 0; j < k; ++j)
+				if (move.toContainers[j] == container && conflicts_.conflicts(item, move.items[j]))
+					return false;
+		}
+		return true;
+	}
+
+	// Slacks of the first packing count +1 and of the second -1; the first
+	// is better if it has more of the largest slack where they differ.
+	static bool lessSlacks(std::pair<double, int>* slacks, size_t slacksCount)
+	{
+		std::sort(slacks, slacks + slacksCount, std::greater< std::pair<double, int> >());
+		for (size_t i = 0; i < slacksCount; ) {
+			int multiplicity = 0;
+			size_t j = i;
+			for (; j < slacksCount && slacks[j].first == slacks[i].first; ++j)
+				multiplicity += slacks[j].second;
+			if (multiplicity != 0)
+				return multiplicity > 0;
+			i = j;
+		}
+		return false;
+	}
+
+	// Both moves change a few containers of the same origin and the origin's
+	// other containers cancel out: the sorted slack vectors first differ at
+	// the largest slack whose multiplicity differs.
+	bool Context::less(const ResultInterface& origin, const Move& firstMove, const Move& secondMove) const
+	{
+		std::pair<double, int> slacks[4 * Move::maxChanged];
+		size_t slacksCount = 0;
+		int deleted = 0;
+		for (size_t c = 0; c < firstMove.changedCount; ++c) {
+			slacks[slacksCount++] = std::make_pair(containerCapacity_ - origin.containersWeights()[firstMove.changedContainers[c]], -1);
+			if (firstMove.changedWeights[c] < emptyWeight)
+				--deleted;
+			else
+				slacks[slacksCount++] = std::make_pair(containerCapacity_ - firstMove.changedWeights[c], 1);
+		}
+		for (size_t c = 0; c < secondMove.changedCount; ++c) {
+			slacks[slacksCount++] = std::make_pair(containerCapacity_ - origin.containersWeights()[secondMove.changedContainers[c]], 1);
+			if (secondMove.changedWeights[c] < emptyWeight)
+				++deleted;
+			else
+				slacks[slacksCount++] = std::make_pair(containerCapacity_ - secondMove.changedWeights[c], -1);
+		}
+		if (deleted != 0)
+			return deleted < 0;
+		return lessSlacks(slacks, slacksCount);
+	}
+
+	bool Context::less(const std::vector<double>& firstWeights, const std::vector<double>& secondWeights) const
+	{
+		std::vector< std::pair<double, int> > slacks;
+		for (size_t c = 0; c < firstWeights.size(); ++c)
+			if (firstWeights[c] >= emptyWeight)
+				slacks.push_back(std::make_pair(containerCapacity_ - firstWeights[c], 1));
+		size_t firstCount = slacks.size();
+		for (size_t c = 0; c < secondWeights.size(); ++c)
+			if (secondWeights[c] >= emptyWeight)
+				slacks.push_back(std::make_pair(containerCapacity_ - secondWeights[c], -1));
+		size_t secondCount = slacks.size() - firstCount;
+		if (firstCount != secondCount)
+			return firstCount < secondCount;
+		return !slacks.empty() && lessSlacks(&slacks[0], slacks.size());
+	}
+
+	bool Context::improves(const ResultInterface& origin, const Move& move) const
+	{
+		return less(origin, move, emptyMove(move.kind));
+	}
+
+	bool Context::fits(const Move& move) const
+	{
+		if (move.overloaded || move.conflicting)
+			return false;
+		for (size_t c = 0; c < move.changedCount; ++c)
+			if (!fits(move.changedWeights[c]))
+				return false;
+		return true;
+	}
+
+	bool Context::fits(double weight) const
+	{
+		return weight <= containerCapacity_ + capacityTolerance;
+	}
+
+	bool Context::fits(const ResultInterface& result, size_t item, size_t container) const
+	{
+		if (!fits(result.containersWeights()[container] + items_[item]))
+			return false;
+		if (conflicts_.hasConflicts(item) && conflicts_.conflictsWith(item, result.containersOccupancy() + container * conflicts_.wordsCount()))
+			return false;
+		return dimensionsCount_ == 1 || rowFits(result.containersResources() + container * resourcesStride_, itemResources(item), resourcesStride_);
+	}
+
+	bool Context::deletesContainer(const Move& move) const
+	{
+		for (size_t c = 0; c < move.changedCount; ++c)
+			if (move.changedWeights[c] < emptyWeight)
+				return true;
+		return false;
+	}
+
 	ResultInterface* Context::createRandomResult() const
 	{
 		bool** matrix = 0;
 		size_t containersCount = 0;
+		const ConflictGraph* conflicts = conflicts_.empty() ? 0 : &conflicts_;
 
-		FFRandomGenerator generator(itemsCount_, items_, containerCapacity_);
-		generator.generate(matrix, containersCount);
+		if (dimensionsCount_ > 1) {
+			VectorFFGenerator generator(itemsCount_, items_, containerCapacity_, &resources_[0], resourcesStride_);
+			generator.setConflicts(conflicts);
+			generator.setRandom(random_);
+			generator.generate(matrix, containersCount);
+		} else if (startGenerator_ == MinimumBinSlack) {
+			MBSGenerator generator(itemsCount_, items_, containerCapacity_);
+			generator.setConflicts(conflicts);
+			generator.setRandom(random_);
+			generator.generate(matrix, containersCount);
+		} else {
+			FFRandomGenerator generator(itemsCount_, items_, containerCapacity_);
+			generator.setConflicts(conflicts);
+			generator.setRandom(random_);
+			generator.generate(matrix, containersCount);
+		}
 
 		return new Result(this, matrix, containersCount);
 	}
 
+	void Context::setStartGenerator(StartGenerator startGenerator)
+	{
+		startGenerator_ = startGenerator;
+	}
+
 	size_t Context::itemsCount() const
 	{
 		return itemsCount_;
@@ -81,4 +357,72 @@ namespace bin_packing
 	{
 		return containerCapacity_;
 	}
+
+	size_t Context::classesCount() const
+	{
+		return classesCount_;
+	}
+
+	size_t Context::itemClass(size_t i) const
+	{
+		return itemsClasses_[i];
+	}
+
+	const std::vector<size_t>& Context::itemsByClass() const
+	{
+		return itemsByClass_;
+	}
+
+	PackingHash Context::classKey(size_t itemClass) const
+	{
+		return classesKeys_[itemClass];
+	}
+
+	size_t Context::dimensionsCount() const
+	{
+		return dimensionsCount_;
+	}
+
+	size_t Context::resourcesStride() const
+	{
+		return resourcesStride_;
+	}
+
+	const double* Context::itemResources(size_t i) const
+	{
+		return &resources_[i * resourcesStride_];
+	}
+
+	void Context::setConflicts(const ConflictGraph& conflicts)
+	{
+		if (conflicts.itemsCount() != itemsCount_)
+			throw 1;
+		conflicts_ = conflicts;
+		initializeClasses();
+	}
+
+	const ConflictGraph& Context::conflicts() const
+	{
+		return conflicts_;
+	}
+
+	bool Context::weightOnly() const
+	{
+		return dimensionsCount_ == 1 && conflicts_.empty();
+	}
+
+	std::ostream& Context::log() const
+	{
+		return *log_;
+	}
+
+	void Context::setLog(std::ostream& log)
+	{
+		log_ = &log;
+	}
+
+	Random& Context::random() const
+	{
+		return random_;
+	}
 }
\ No newline at end of file
@@ -1,31 +1,109 @@
 #ifndef CONTEXT_H
 #define CONTEXT_H
 
+#include <cstddef>
+#include <iosfwd>
+#include <vector>
+
+#include "PackingHash.h"
+#include "ConflictGraph.h"
+#include "Random.h"
+
 namespace bin_packing
 {
 	class ResultInterface;
 	class RandomGenerator;
+	struct Move;
+
+	// How far a load may exceed the capacity and still fit, so that decimal
+	// weights summing to exactly the capacity are not rejected by rounding.
+	static const double capacityTolerance = 1e-9;
 
 	class Context
 	{
 	public:
+		enum StartGenerator { RandomFirstFit, MinimumBinSlack };
+
 		Context(double containerCapacity, size_t itemsCount, double* items, size_t bestKnownNumberOfContainers);
+		// Vector packing: item i needs resources[i * dimensionsCount + k] of
+		// the capacities[k] every container offers. The weight of an item is
+		// the sum of its resources relative to the capacities, so the
+		// objective compares total relative slacks.
+		Context(size_t dimensionsCount, const double* capacities, size_t itemsCount, const double* resources, size_t bestKnownNumberOfContainers);
 
 		bool less(const ResultInterface& firstResult, const ResultInterface& secondResult) const;
+		void score(const ResultInterface& origin, Move& move) const;
+		bool less(const ResultInterface& origin, const Move& firstMove, const Move& secondMove) const;
+		// Compares two packings that differ only in a few containers, given
+		// by their weights in each; empty containers do not count.
+		bool less(const std::vector<double>& firstWeights, const std::vector<double>& secondWeights) const;
+		bool improves(const ResultInterface& origin, const Move& move) const;
+		bool fits(const Move& move) const;
+		bool fits(double weight) const;
+		bool fits(const ResultInterface& result, size_t item, size_t container) const;
+		bool deletesContainer(const Move& move) const;
 		virtual ResultInterface* createRandomResult() const;
+		void setStartGenerator(StartGenerator startGenerator);
 
 		size_t itemsCount() const;
 		double itemWeight(size_t i) const;
 		double containerCapacity() const;
         size_t bestKnownNumberOfContainers() const;
 
+		size_t classesCount() const;
+		size_t itemClass(size_t i) const;
+		const std::vector<size_t>& itemsByClass() const;
+		PackingHash classKey(size_t itemClass) const;
+
+		size_t dimensionsCount() const;
+		size_t resourcesStride() const;
+		const double* itemResources(size_t i) const;
+
+		// Must be set before any Result of the context is created, since
+		// items with conflicts get weight classes of their own.
+		void setConflicts(const ConflictGraph& conflicts);
+		const ConflictGraph& conflicts() const;
+		// One dimension and no conflicts, so a packing is feasible as soon as
+		// no container weighs more than the capacity. Everything that packs
+		// by weight alone (Packing, OnlinePacker, the large neighbourhood
+		// repair, warm starts) requires it and throws otherwise.
+		bool weightOnly() const;
+
+		// Searches write their progress to the log, std::cout unless set,
+		// and draw every random number from the context's own generator,
+		// which starts from seed 0. Searches on different threads therefore
+		// need different contexts.
+		std::ostream& log() const;
+		void setLog(std::ostream& log);
+		Random& random() const;
+
 	private:
+		void initializeClasses();
+		bool resourcesFit(const ResultInterface& origin, const Move& move) const;
+		bool conflictFree(const ResultInterface& origin, const Move& move) const;
+
 		double containerCapacity_;
 		size_t itemsCount_;
 		double* items_;
         size_t bestKnownNumberOfContainers_;
 
+		std::vector<size_t> itemsClasses_;
+		std::vector<size_t> itemsByClass_;
+		size_t classesCount_;
+		std::vector<PackingHash> classesKeys_;
+
 		RandomGenerator* generator_;
+		StartGenerator startGenerator_;
+
+		size_t dimensionsCount_;
+		size_t resourcesStride_;
+		std::vector<double> resources_;
+		std::vector<double> relativeWeights_;
+
+		ConflictGraph conflicts_;
+
+		std::ostream* log_;
+		mutable Random random_;
 	};
 }
 
@@ -0,0 +1,149 @@
+#include "ElitePool.h"
+#include "Context.h"
+#include "ResultInterface.h"
+
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+namespace bin_packing
+{
+	typedef std::vector< std::vector< std::pair<size_t, size_t> > > ClassesContainers;
+
+	// For every class, the containers holding its items and how many of them.
+	static void collectClassesContainers(const ResultInterface& result, ClassesContainers& classesContainers)
+	{
+		const Context* context = result.context();
+		classesContainers.assign(context->classesCount(), std::vector< std::pair<size_t, size_t> >());
+		for (size_t i = 0; i < context->itemsCount(); ++i) {
+			std::vector< std::pair<size_t, size_t> >& containers = classesContainers[context->itemClass(i)];
+			size_t container = result.containerOf(i);
+			size_t c = 0;
+			while (c < containers.size() && containers[c].first != container)
+				++c;
+			if (c == containers.size())
+				containers.push_back(std::make_pair(container, 0));
+			++containers[c].second;
+		}
+	}
+
+	size_t matchContainers(const ResultInterface& source, const ResultInterface& guide, std::vector<size_t>& targets)
+	{
+		ClassesContainers sourceContainers, guideContainers;
+		collectClassesContainers(source, sourceContainers);
+		collectClassesContainers(guide, guideContainers);
+
+		size_t sourceCount = source.containersCount();
+		size_t guideCount = guide.containersCount();
+		std::vector<size_t> overlaps(sourceCount * guideCount, 0);
+		for (size_t k = 0; k < sourceContainers.size(); ++k)
+			for (size_t s = 0; s < sourceContainers[k].size(); ++s)
+				for (size_t g = 0; g < guideContainers[k].size(); ++g)
+					overlaps[sourceContainers[k][s].first * guideCount + guideContainers[k][g].first] +=
+						std::min(sourceContainers[k][s].second, guideContainers[k][g].second);
+
+		std::vector< std::pair<size_t, size_t> > pairs;
+		for (size_t p = 0; p < overlaps.size(); ++p)
+			if (overlaps[p] > 0)
+				pairs.push_back(std::make_pair(overlaps[p], p));
+		std::sort(pairs.begin(), pairs.end(), std::greater< std::pair<size_t, size_t> >());
+
+		targets.assign(sourceCount, noTarget);
+		std::vector<bool> matched(guideCount, false);
+		size_t kept = 0;
+		for (size_t p = 0; p < pairs.size(); ++p) {
+			size_t s = pairs[p].second / guideCount;
+			size_t g = pairs[p].second % guideCount;
+			if (targets[s] == noTarget && !matched[g]) {
+				targets[s] = g;
+				matched[g] = true;
+				kept += pairs[p].first;
+			}
+		}
+
+		size_t g = 0;
+		for (size_t s = 0; s < sourceCount; ++s) {
+			if (targets[s] != noTarget)
+				continue;
+			while (g < guideCount && matched[g])
+				++g;
+			if (g == guideCount)
+				break;
+			targets[s] = g;
+			matched[g] = true;
+		}
+		return source.context()->itemsCount() - kept;
+	}
+
+	ElitePool::ElitePool(const Context* context, size_t capacity, size_t minDistance) : context_(context), capacity_(capacity), minDistance_(minDistance)
+	{
+	}
+
+	ElitePool::~ElitePool()
+	{
+		for (size_t i = 0; i < results_.size(); ++i)
+			delete results_[i];
+	}
+
+	bool ElitePool::offer(const ResultInterface& result)
+	{
+		std::vector<size_t> targets;
+		size_t closest = results_.size();
+		size_t closestDistance = 0;
+		for (size_t i = 0; i < results_.size(); ++i) {
+			size_t distance = results_[i]->hash() == result.hash() ? 0 : matchContainers(result, *results_[i], targets);
+			if (closest == results_.size() || distance < closestDistance) {
+				closest = i;
+				closestDistance = distance;
+			}
+		}
+
+		if (closest < results_.size() && closestDistance < minDistance_) {
+			if (!context_->less(result, *results_[closest]))
+				return false;
+			delete results_[closest];
+			results_[closest] = result.clone();
+			return true;
+		}
+
+		if (results_.size() < capacity_) {
+			results_.push_back(result.clone());
+			return true;
+		}
+
+		size_t replaced = worst();
+		if (!context_->less(result, *results_[replaced]))
+			return false;
+		delete results_[replaced];
+		results_[replaced] = result.clone();
+		return true;
+	}
+
+	size_t ElitePool::size() const
+	{
+		return results_.size();
+	}
+
+	const ResultInterface& ElitePool::at(size_t i) const
+	{
+		return *results_[i];
+	}
+
+	const ResultInterface& ElitePool::best() const
+	{
+		size_t best = 0;
+		for (size_t i = 1; i < results_.size(); ++i)
+			if (context_->less(*results_[i], *results_[best]))
+				best = i;
+		return *results_[best];
+	}
+
+	size_t ElitePool::worst() const
+	{
+		size_t worst = 0;
+		for (size_t i = 1; i < results_.size(); ++i)
+			if (context_->less(*results_[worst], *results_[i]))
+				worst = i;
+		return worst;
+	}
+}
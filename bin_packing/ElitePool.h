@@ -0,0 +1,46 @@
+#ifndef ELITE_POOL_H
+#define ELITE_POOL_H
+
+#include <cstddef>
+#include <vector>
+
+namespace bin_packing
+{
+	class Context;
+	class ResultInterface;
+
+	static const size_t noTarget = static_cast<size_t>(-1);
+
+	// Matches every container of source to the guide container sharing the
+	// most items with it, counting items of one weight class as equal, and
+	// returns how many items of source are outside their matched container.
+	// targets[c] is the guide container of source container c, or noTarget
+	// when source has more containers than guide.
+	size_t matchContainers(const ResultInterface& source, const ResultInterface& guide, std::vector<size_t>& targets);
+
+	// Bounded pool of good, mutually distant packings. A packing closer than
+	// minDistance to a member only replaces it when it is better; otherwise
+	// it replaces the worst member once the pool is full, if it beats it.
+	class ElitePool
+	{
+	public:
+		ElitePool(const Context* context, size_t capacity, size_t minDistance = 2);
+		~ElitePool();
+
+		bool offer(const ResultInterface& result);
+
+		size_t size() const;
+		const ResultInterface& at(size_t i) const;
+		const ResultInterface& best() const;
+
+	private:
+		size_t worst() const;
+
+		const Context* context_;
+		size_t capacity_;
+		size_t minDistance_;
+		std::vector<ResultInterface*> results_;
+	};
+}
+
+#endif // ELITE_POOL_H
@@ -0,0 +1,99 @@
+#include "InstanceGenerator.h"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+
+namespace bin_packing
+{
+	static size_t randomIndex(size_t bound)
+	{
+		size_t value = static_cast<size_t>(std::rand());
+		value = value * (static_cast<size_t>(RAND_MAX) + 1) + static_cast<size_t>(std::rand());
+		return value % bound;
+	}
+
+	static int randomBetween(int low, int high)
+	{
+		return low + static_cast<int>(randomIndex(static_cast<size_t>(high - low + 1)));
+	}
+
+	static std::string dataSetName(char prefix, size_t itemsCount, size_t dataSetNumber)
+	{
+		std::stringstream ss;
+		ss << ' ' << prefix << itemsCount << '_' << std::setw(2) << std::setfill('0') << dataSetNumber << ' ';
+		return ss.str();
+	}
+
+	InstanceGenerator::InstanceGenerator(Kind kind, size_t itemsCount) : kind_(kind), itemsCount_(itemsCount)
+	{
+		if (kind_ == Triplet)
+			itemsCount_ -= itemsCount_ % 3;
+		if (itemsCount_ == 0)
+			throw 1;
+	}
+
+	void InstanceGenerator::write(const std::string& filename, size_t dataSetsCount) const
+	{
+		std::ofstream file(filename.c_str(), std::ios::out);
+		if (!file.is_open())
+			throw 1;
+		write(file, dataSetsCount);
+		file.close();
+	}
+
+	void InstanceGenerator::write(std::ostream& stream, size_t dataSetsCount) const
+	{
+		stream << dataSetsCount << '\n';
+		for (size_t i = 0; i < dataSetsCount; ++i) {
+			if (kind_ == Uniform)
+				writeUniform(stream, i);
+			else
+				writeTriplet(stream, i);
+		}
+	}
+
+	void InstanceGenerator::writeUniform(std::ostream& stream, size_t dataSetNumber) const
+	{
+		const int containerCapacity = 150;
+
+		std::vector<int> items(itemsCount_);
+		double weight = 0.0;
+		for (size_t i = 0; i < itemsCount_; ++i) {
+			items[i] = randomBetween(20, 100);
+			weight += items[i];
+		}
+		size_t lowerBound = static_cast<size_t>(std::ceil(weight / containerCapacity));
+
+		stream << dataSetName('u', itemsCount_, dataSetNumber) << '\n';
+		stream << ' ' << containerCapacity << ' ' << itemsCount_ << ' ' << lowerBound << '\n';
+		for (size_t i = 0; i < itemsCount_; ++i)
+			stream << items[i] << '\n';
+	}
+
+	void InstanceGenerator::writeTriplet(std::ostream& stream, size_t dataSetNumber) const
+	{
+		const int containerCapacity = 1000;
+
+		std::vector<int> items;
+		items.reserve(itemsCount_);
+		for (size_t i = 0; i < itemsCount_ / 3; ++i) {
+			int first = randomBetween(380, 490);
+			int second = randomBetween(250, (containerCapacity - first) / 2);
+			items.push_back(first);
+			items.push_back(second);
+			items.push_back(containerCapacity - first - second);
+		}
+		for (size_t i = items.size(); i > 1; --i)
+			std::swap(items[i - 1], items[randomIndex(i)]);
+
+		stream << dataSetName('t', itemsCount_, dataSetNumber) << '\n';
+		stream << ' ' << containerCapacity / 10 << ".0 " << itemsCount_ << ' ' << itemsCount_ / 3 << '\n';
+		for (size_t i = 0; i < items.size(); ++i)
+			stream << items[i] / 10 << '.' << items[i] % 10 << '\n';
+	}
+}
@@ -0,0 +1,33 @@
+#ifndef INSTANCE_GENERATOR_H
+#define INSTANCE_GENERATOR_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+namespace bin_packing
+{
+	// Falkenauer-style instances in the OR-Library format read by DataLoader:
+	// "uniform" draws integer weights from [20, 100] for capacity 150,
+	// "triplet" builds groups of three items that fill a capacity 100.0
+	// container exactly, so the optimum is itemsCount / 3.
+	class InstanceGenerator
+	{
+	public:
+		enum Kind { Uniform, Triplet };
+
+		InstanceGenerator(Kind kind, size_t itemsCount);
+
+		void write(const std::string& filename, size_t dataSetsCount) const;
+		void write(std::ostream& stream, size_t dataSetsCount) const;
+
+	private:
+		void writeUniform(std::ostream& stream, size_t dataSetNumber) const;
+		void writeTriplet(std::ostream& stream, size_t dataSetNumber) const;
+
+		Kind kind_;
+		size_t itemsCount_;
+	};
+}
+
+#endif // INSTANCE_GENERATOR_H
@@ -0,0 +1,59 @@
+#include "Island.h"
+#include "Context.h"
+#include "ResultInterface.h"
+#include "Serialization.h"
+
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+namespace bin_packing
+{
+	Island::Island(const Context* context, const std::string& directory, size_t islandId, size_t islandsCount) : context_(context),
+		directory_(directory), islandId_(islandId), islandsCount_(islandsCount)
+	{
+		if (islandsCount_ == 0 || islandId_ >= islandsCount_)
+			throw 1;
+	}
+
+	void Island::publish(const ResultInterface& result) const
+	{
+		std::string finalPath = path(islandId_);
+		std::string temporaryPath = finalPath + ".tmp";
+		std::ofstream file(temporaryPath.c_str(), std::ios::out | std::ios::binary);
+		if (!file.is_open())
+			throw 1;
+		writeResult(file, result);
+		file.close();
+
+		// A neighbour may hold the old file open (Windows refuses to replace
+		// it then); the next epoch publishes again.
+		std::remove(finalPath.c_str());
+		if (std::rename(temporaryPath.c_str(), finalPath.c_str()) != 0)
+			std::remove(temporaryPath.c_str());
+	}
+
+	// The packing last published by the previous island on the ring, or 0
+	// when it has not published one yet.
+	ResultInterface* Island::migrant() const
+	{
+		if (islandsCount_ < 2)
+			return 0;
+
+		std::ifstream file(path((islandId_ + islandsCount_ - 1) % islandsCount_).c_str(), std::ios::in | std::ios::binary);
+		if (!file.is_open())
+			return 0;
+		try {
+			return readResult(file, *context_);
+		} catch (int) {
+			return 0;
+		}
+	}
+
+	std::string Island::path(size_t islandId) const
+	{
+		std::stringstream ss;
+		ss << directory_ << "/island" << islandId << ".bin";
+		return ss.str();
+	}
+}
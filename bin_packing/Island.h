@@ -0,0 +1,36 @@
+#ifndef ISLAND_H
+#define ISLAND_H
+
+#include <cstddef>
+#include <string>
+
+namespace bin_packing
+{
+	class Context;
+	class ResultInterface;
+
+	// One island of a multi-process search: every solver process runs its own
+	// search and islands on a ring pass their best packings on through a
+	// shared directory. A packing is published in the compact binary
+	// encoding of Serialization.h, written to a temporary file and renamed
+	// over the island's file, so a neighbour never reads half of it and a
+	// crashed island only stops sending.
+	class Island
+	{
+	public:
+		Island(const Context* context, const std::string& directory, size_t islandId, size_t islandsCount);
+
+		void publish(const ResultInterface& result) const;
+		ResultInterface* migrant() const;
+
+	private:
+		std::string path(size_t islandId) const;
+
+		const Context* context_;
+		std::string directory_;
+		size_t islandId_;
+		size_t islandsCount_;
+	};
+}
+
+#endif // ISLAND_H
@@ -0,0 +1,99 @@
+#ifndef MOVE_H
+#define MOVE_H
+
+#include <cstddef>
+
+namespace bin_packing
+{
+	// Describes the step from a Result to one of its neighbours as a short
+	// sequence of item relocations, so that the step can be scored against
+	// the Result and applied to (and undone on) it in place. Only the first
+	// "from" container may become empty; deletedContainer is filled in by
+	// Result::apply when it does. Context::score caches the new weights of
+	// the containers the move changes, which is all Context::less and
+	// Context::fits need; it also records whether the move overloads any
+	// resource of a container in vector packing, or puts conflicting items
+	// together. Moves are plain data and are never allocated one by one.
+	struct Move
+	{
+		enum Kind { Relocation, Exchange, TwoOneExchange, TwoTwoExchange, EjectionChain };
+		enum { maxLength = 4, maxChanged = maxLength + 1 };
+
+		Kind kind;
+		size_t length;
+		size_t items[maxLength];
+		size_t fromContainers[maxLength];
+		size_t toContainers[maxLength];
+		bool deletedContainer;
+
+		size_t changedCount;
+		size_t changedContainers[maxChanged];
+		double changedWeights[maxChanged];
+		bool overloaded;
+		bool conflicting;
+	};
+
+	inline void addRelocation(Move& move, size_t item, size_t fromContainer, size_t toContainer)
+	{
+		move.items[move.length] = item;
+		move.fromContainers[move.length] = fromContainer;
+		move.toContainers[move.length] = toContainer;
+		++move.length;
+	}
+
+	inline Move emptyMove(Move::Kind kind)
+	{
+		Move move;
+		move.kind = kind;
+		move.length = 0;
+		move.deletedContainer = false;
+		move.changedCount = 0;
+		move.overloaded = false;
+		move.conflicting = false;
+		return move;
+	}
+
+	inline Move relocation(size_t item, size_t fromContainer, size_t toContainer)
+	{
+		Move move = emptyMove(Move::Relocation);
+		addRelocation(move, item, fromContainer, toContainer);
+		return move;
+	}
+
+	inline Move exchange(size_t firstItem, size_t firstContainer, size_t secondItem, size_t secondContainer)
+	{
+		Move move = emptyMove(Move::Exchange);
+		addRelocation(move, firstItem, firstContainer, secondContainer);
+		addRelocation(move, secondItem, secondContainer, firstContainer);
+		return move;
+	}
+
+	inline Move twoOneExchange(size_t firstItem, size_t secondItem, size_t firstContainer, size_t thirdItem, size_t secondContainer)
+	{
+		Move move = emptyMove(Move::TwoOneExchange);
+		addRelocation(move, firstItem, firstContainer, secondContainer);
+		addRelocation(move, secondItem, firstContainer, secondContainer);
+		addRelocation(move, thirdItem, secondContainer, firstContainer);
+		return move;
+	}
+
+	inline Move twoTwoExchange(size_t firstItem, size_t secondItem, size_t firstContainer, size_t thirdItem, size_t fourthItem, size_t secondContainer)
+	{
+		Move move = emptyMove(Move::TwoTwoExchange);
+		addRelocation(move, firstItem, firstContainer, secondContainer);
+		addRelocation(move, secondItem, firstContainer, secondContainer);
+		addRelocation(move, thirdItem, secondContainer, firstContainer);
+		addRelocation(move, fourthItem, secondContainer, firstContainer);
+		return move;
+	}
+
+	inline Move ejectionChain(size_t firstItem, size_t firstContainer, size_t secondItem, size_t secondContainer, size_t thirdContainer)
+	{
+		Move move = emptyMove(Move::EjectionChain);
+		addRelocation(move, firstItem, firstContainer, secondContainer);
+		addRelocation(move, secondItem, secondContainer, thirdContainer);
+		return move;
+	}
+}
+
+#endif // MOVE_H
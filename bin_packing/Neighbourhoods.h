@@ -0,0 +1,321 @@
+#ifndef NEIGHBOURHOODS_H
+#define NEIGHBOURHOODS_H
+
+#include "Context.h"
+#include "ResultInterface.h"
+#include "Move.h"
+
+#include <vector>
+#include <algorithm>
+
+namespace bin_packing
+{
+	// Each neighbourhood enumerates its feasible, scored moves of a Result
+	// through the per-container item lists and hands them to a visitor.
+	// Searches are templates over the neighbourhood and the visitor, so the
+	// whole inner loop is inlined. The items of a container are grouped by
+	// weight class and only the first item of a class is tried in each
+	// position, since any other one leads to the same packing.
+	typedef std::vector< std::vector<size_t> > ContainersItems;
+
+	inline void collectContainersItems(const ResultInterface& result, ContainersItems& containersItems)
+	{
+		containersItems.resize(result.containersCount());
+		for (size_t c = 0; c < containersItems.size(); ++c)
+			containersItems[c].clear();
+
+		const std::vector<size_t>& itemsByClass = result.context()->itemsByClass();
+		for (size_t i = 0; i < itemsByClass.size(); ++i)
+			containersItems[result.containerOf(itemsByClass[i])].push_back(itemsByClass[i]);
+	}
+
+	inline void insertByClass(const Context& context, std::vector<size_t>& items, size_t item)
+	{
+		size_t position = items.size();
+		items.push_back(item);
+		while (position > 0 && context.itemClass(items[position - 1]) > context.itemClass(item)) {
+			items[position] = items[position - 1];
+			--position;
+		}
+		items[position] = item;
+	}
+
+	inline void updateContainersItems(const Context& context, ContainersItems& containersItems, const Move& move)
+	{
+		for (size_t k = 0; k < move.length; ++k) {
+			std::vector<size_t>& from = containersItems[move.fromContainers[k]];
+			from.erase(std::find(from.begin(), from.end(), move.items[k]));
+			insertByClass(context, containersItems[move.toContainers[k]], move.items[k]);
+		}
+		if (move.deletedContainer) {
+			containersItems[move.fromContainers[0]].swap(containersItems.back());
+			containersItems.pop_back();
+		}
+	}
+
+	inline bool repeatsClass(const Context& context, const std::vector<size_t>& items, size_t index, size_t first)
+	{
+		return index > first && context.itemClass(items[index]) == context.itemClass(items[index - 1]);
+	}
+
+	// A visitor returns false once it has seen enough moves, and the
+	// neighbourhood then stops enumerating and returns false as well.
+	template <class Visitor> inline bool offerMove(const Context& context, const ResultInterface& result, Move& move, Visitor& visitor)
+	{
+		context.score(result, move);
+		return !context.fits(move) || visitor(move);
+	}
+
+	struct Relocations
+	{
+		template <class Visitor> static bool visit(const Context& context, const ResultInterface& result, const ContainersItems& containersItems, Visitor& visitor)
+		{
+			for (size_t x = 0; x < containersItems.size(); ++x)
+				if (!visitFrom(context, result, containersItems, x, visitor))
+					return false;
+			return true;
+		}
+
+		template <class Visitor> static bool visitFrom(const Context& context, const ResultInterface& result, const ContainersItems& containersItems, size_t x, Visitor& visitor)
+		{
+			size_t containersCount = containersItems.size();
+			for (size_t a = 0; a < containersItems[x].size(); ++a) {
+				if (repeatsClass(context, containersItems[x], a, 0))
+					continue;
+				for (size_t y = 0; y < containersCount; ++y) {
+					if (y == x)
+						continue;
+					Move move = relocation(containersItems[x][a], x, y);
+					if (!offerMove(context, result, move, visitor))
+						return false;
+				}
+			}
+			return true;
+		}
+	};
+
+	struct Exchanges
+	{
+		template <class Visitor> static bool visit(const Context& context, const ResultInterface& result, const ContainersItems& containersItems, Visitor& visitor)
+		{
+			for (size_t x = 0; x < containersItems.size(); ++x)
+				for (size_t y = x + 1; y < containersItems.size(); ++y)
+					if (!visitBetween(context, result, containersItems, x, y, visitor))
+						return false;
+			return true;
+		}
+
+		template <class Visitor> static bool visitFrom(const Context& context, const ResultInterface& result, const ContainersItems& containersItems, size_t x, Visitor& visitor)
+		{
+			for (size_t y = 0; y < containersItems.size(); ++y)
+				if (y != x && !visitBetween(context, result, containersItems, x, y, visitor))
+					return false;
+			return true;
+		}
+
+		template <class Visitor> static bool visitBetween(const Context& context, const ResultInterface& result, const ContainersItems& containersItems, size_t x, size_t y, Visitor& visitor)
+		{
+			for (size_t a = 0; a < containersItems[x].size(); ++a) {
+				if (repeatsClass(context, containersItems[x], a, 0))
+					continue;
+				for (size_t c = 0; c < containersItems[y].size(); ++c) {
+					if (repeatsClass(context, containersItems[y], c, 0) || context.itemClass(containersItems[x][a]) == context.itemClass(containersItems[y][c]))
+						continue;
+					Move move = exchange(containersItems[x][a], x, containersItems[y][c], y);
+					if (!offerMove(context, result, move, visitor))
+						return false;
+				}
+			}
+			return true;
+		}
+	};
+
+	struct TwoOneExchanges
+	{
+		template <class Visitor> static bool visit(const Context& context, const ResultInterface& result, const ContainersItems& containersItems, Visitor& visitor)
+		{
+			size_t containersCount = containersItems.size();
+			for (size_t x = 0; x < containersCount; ++x) {
+				for (size_t a = 0; a < containersItems[x].size(); ++a) {
+					if (repeatsClass(context, containersItems[x], a, 0))
+						continue;
+					for (size_t b = a + 1; b < containersItems[x].size(); ++b) {
+						if (repeatsClass(context, containersItems[x], b, a + 1))
+							continue;
+						for (size_t y = 0; y < containersCount; ++y) {
+							if (y == x)
+								continue;
+							for (size_t c = 0; c < containersItems[y].size(); ++c) {
+								if (repeatsClass(context, containersItems[y], c, 0))
+									continue;
+								Move move = twoOneExchange(containersItems[x][a], containersItems[x][b], x, containersItems[y][c], y);
+								if (!offerMove(context, result, move, visitor))
+									return false;
+							}
+						}
+					}
+				}
+			}
+			return true;
+		}
+	};
+
+	struct TwoTwoExchanges
+	{
+		template <class Visitor> static bool visit(const Context& context, const ResultInterface& result, const ContainersItems& containersItems, Visitor& visitor)
+		{
+			size_t containersCount = containersItems.size();
+			for (size_t x = 0; x < containersCount; ++x) {
+				for (size_t y = x + 1; y < containersCount; ++y) {
+					for (size_t a = 0; a < containersItems[x].size(); ++a) {
+						if (repeatsClass(context, containersItems[x], a, 0))
+							continue;
+						for (size_t b = a + 1; b < containersItems[x].size(); ++b) {
+							if (repeatsClass(context, containersItems[x], b, a + 1))
+								continue;
+							for (size_t c = 0; c < containersItems[y].size(); ++c) {
+								if (repeatsClass(context, containersItems[y], c, 0))
+									continue;
+								for (size_t d = c + 1; d < containersItems[y].size(); ++d) {
+									if (repeatsClass(context, containersItems[y], d, c + 1))
+										continue;
+									Move move = twoTwoExchange(containersItems[x][a], containersItems[x][b], x, containersItems[y][c], containersItems[y][d], y);
+									if (!offerMove(context, result, move, visitor))
+										return false;
+								}
+							}
+						}
+					}
+				}
+			}
+			return true;
+		}
+	};
+
+	struct EjectionChains
+	{
+		class FullerContainer
+		{
+		public:
+			FullerContainer(const ResultInterface& result) : weights_(result.containersWeights())
+			{
+			}
+
+			bool operator()(size_t first, size_t second) const
+			{
+				return weights_[first] > weights_[second];
+			}
+
+		private:
+			const double* weights_;
+		};
+
+		template <class Visitor> static bool visit(const Context& context, const ResultInterface& result, const ContainersItems& containersItems, Visitor& visitor)
+		{
+			size_t containersCount = containersItems.size();
+			const double* weights = result.containersWeights();
+
+			std::vector<size_t> byResidual(containersCount);
+			for (size_t z = 0; z < containersCount; ++z)
+				byResidual[z] = z;
+			std::sort(byResidual.begin(), byResidual.end(), FullerContainer(result));
+
+			for (size_t x = 0; x < containersCount; ++x) {
+				for (size_t a = 0; a < containersItems[x].size(); ++a) {
+					if (repeatsClass(context, containersItems[x], a, 0))
+						continue;
+					double first = context.itemWeight(containersItems[x][a]);
+					for (size_t y = 0; y < containersCount; ++y) {
+						if (y == x || context.fits(result, containersItems[x][a], y))
+							continue;
+						for (size_t c = 0; c < containersItems[y].size(); ++c) {
+							if (repeatsClass(context, containersItems[y], c, 0))
+								continue;
+							double second = context.itemWeight(containersItems[y][c]);
+							if (!context.fits(weights[y] - second + first))
+								continue;
+							for (size_t z = 0; z < containersCount; ++z) {
+								size_t candidate = byResidual[z];
+								if (candidate != x && candidate != y && context.fits(result, containersItems[y][c], candidate)) {
+									Move move = ejectionChain(containersItems[x][a], x, containersItems[y][c], y, candidate);
+									if (!offerMove(context, result, move, visitor))
+										return false;
+									break;
+								}
+							}
+						}
+					}
+				}
+			}
+			return true;
+		}
+	};
+
+	class BestMove
+	{
+	public:
+		BestMove(const Context& context, const ResultInterface& result) : context_(context), result_(result), found_(false)
+		{
+		}
+
+		bool operator()(const Move& move)
+		{
+			if (found_ ? context_.less(result_, move, move_) : context_.improves(result_, move)) {
+				move_ = move;
+				found_ = true;
+			}
+			return true;
+		}
+
+		bool found() const
+		{
+			return found_;
+		}
+
+		const Move& move() const
+		{
+			return move_;
+		}
+
+	private:
+		const Context& context_;
+		const ResultInterface& result_;
+		bool found_;
+		Move move_;
+	};
+
+	class FirstMove
+	{
+	public:
+		FirstMove(const Context& context, const ResultInterface& result) : context_(context), result_(result), found_(false)
+		{
+		}
+
+		bool operator()(const Move& move)
+		{
+			if (context_.improves(result_, move)) {
+				move_ = move;
+				found_ = true;
+			}
+			return !found_;
+		}
+
+		bool found() const
+		{
+			return found_;
+		}
+
+		const Move& move() const
+		{
+			return move_;
+		}
+
+	private:
+		const Context& context_;
+		const ResultInterface& result_;
+		bool found_;
+		Move move_;
+	};
+}
+
+#endif // NEIGHBOURHOODS_H
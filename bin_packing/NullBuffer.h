@@ -0,0 +1,25 @@
+#ifndef NULL_BUFFER_H
+#define NULL_BUFFER_H
+
+#include <streambuf>
+
+namespace bin_packing
+{
+	// Stream buffer that discards everything, behind the log of a context
+	// whose search progress is not wanted.
+	class NullBuffer : public std::streambuf
+	{
+	protected:
+		virtual int_type overflow(int_type c)
+		{
+			return traits_type::not_eof(c);
+		}
+
+		virtual std::streamsize xsputn(const char*, std::streamsize count)
+		{
+			return count;
+		}
+	};
+}
+
+#endif // NULL_BUFFER_H
@@ -0,0 +1,346 @@
+#include "OnlinePacker.h"
+#include "Context.h"
+#include "Result.h"
+#include "ResultInterface.h"
+#include "Algorithms.h"
+
+#include <set>
+
+namespace bin_packing
+{
+	static const size_t noContainer = static_cast<size_t>(-1);
+
+	OnlinePacker::OnlinePacker(double containerCapacity, size_t repackWindow, size_t repackPeriod) : containerCapacity_(containerCapacity),
+		repackWindow_(repackWindow), repackPeriod_(repackPeriod), updatesSinceRepack_(0), batching_(false), containersCount_(0), itemsCount_(0), stamp_(0)
+	{
+	}
+
+	OnlinePacker::OnlinePacker(const ResultInterface& result, size_t repackWindow, size_t repackPeriod) : containerCapacity_(result.context()->containerCapacity()),
+		repackWindow_(repackWindow), repackPeriod_(repackPeriod), updatesSinceRepack_(0), batching_(false), containersCount_(0), itemsCount_(0), stamp_(0)
+	{
+		const Context* context = result.context();
+		if (!context->weightOnly())
+			throw 1;
+		for (size_t c = 0; c < result.containersCount(); ++c)
+			openContainer();
+
+		itemsCount_ = context->itemsCount();
+		itemsWeights_.resize(itemsCount_);
+		itemsContainers_.resize(itemsCount_);
+		itemsPositions_.resize(itemsCount_);
+		for (size_t i = 0; i < itemsCount_; ++i) {
+			itemsWeights_[i] = context->itemWeight(i);
+			place(i, result.containerOf(i));
+		}
+
+		for (size_t c = 0; c < result.containersCount(); ++c)
+			updateResidual(c);
+	}
+
+	size_t OnlinePacker::insert(double weight)
+	{
+		size_t item = insertItem(weight);
+		countUpdate();
+		return item;
+	}
+
+	void OnlinePacker::remove(size_t item)
+	{
+		removeItem(item);
+		countUpdate();
+	}
+
+	void OnlinePacker::changeWeight(size_t item, double weight)
+	{
+		changeItemWeight(item, weight);
+		countUpdate();
+	}
+
+	void OnlinePacker::update(const std::vector<PackingUpdate>& updates, std::vector<size_t>& insertedItems)
+	{
+		// The whole batch is checked first, so a bad update leaves the packing
+		// as it was. Items removed earlier in the batch count as gone.
+		std::set<size_t> removed;
+		for (size_t u = 0; u < updates.size(); ++u) {
+			const PackingUpdate& update = updates[u];
+			if (update.kind != PackingUpdate::Insertion && (!contains(update.item) || removed.count(update.item) > 0))
+				throw 1;
+			if (update.kind != PackingUpdate::Removal && !validWeight(update.weight))
+				throw 1;
+			if (update.kind == PackingUpdate::Removal)
+				removed.insert(update.item);
+		}
+
+		insertedItems.clear();
+		recentContainers_.clear();
+		batching_ = true;
+		try {
+			for (size_t u = 0; u < updates.size(); ++u) {
+				switch (updates[u].kind) {
+				case PackingUpdate::Insertion:
+					insertedItems.push_back(insertItem(updates[u].weight));
+					break;
+				case PackingUpdate::Removal:
+					removeItem(updates[u].item);
+					break;
+				case PackingUpdate::WeightChange:
+					changeItemWeight(updates[u].item, updates[u].weight);
+					break;
+				}
+			}
+		} catch (...) {
+			batching_ = false;
+			throw;
+		}
+		batching_ = false;
+
+		++stamp_;
+		std::vector<size_t> window;
+		for (size_t i = 0; i < recentContainers_.size(); ++i) {
+			size_t container = recentContainers_[i];
+			if (containerStamps_[container] != stamp_ && !containerItems_[container].empty()) {
+				containerStamps_[container] = stamp_;
+				window.push_back(container);
+			}
+		}
+		recentContainers_.clear();
+
+		size_t affectedCount = window.size();
+		for (ResidualTree::reverse_iterator i = residuals_.rbegin(); i != residuals_.rend() && window.size() < 2 * affectedCount; ++i) {
+			if (containerStamps_[i->second] != stamp_) {
+				containerStamps_[i->second] = stamp_;
+				window.push_back(i->second);
+			}
+		}
+		repackContainers(window);
+	}
+
+	size_t OnlinePacker::insertItem(double weight)
+	{
+		if (!validWeight(weight))
+			throw 1;
+
+		size_t item;
+		if (freeItems_.empty()) {
+			item = itemsWeights_.size();
+			itemsWeights_.push_back(weight);
+			itemsContainers_.push_back(noContainer);
+			itemsPositions_.push_back(0);
+		} else {
+			item = freeItems_.back();
+			freeItems_.pop_back();
+			itemsWeights_[item] = weight;
+		}
+		++itemsCount_;
+
+		placeBestFit(item);
+		return item;
+	}
+
+	void OnlinePacker::removeItem(size_t item)
+	{
+		size_t container = containerOf(item);
+		unplace(item);
+		itemsContainers_[item] = noContainer;
+		freeItems_.push_back(item);
+		--itemsCount_;
+
+		if (containerItems_[container].empty()) {
+			closeContainer(container);
+		} else {
+			updateResidual(container);
+			touch(container);
+		}
+	}
+
+	void OnlinePacker::changeItemWeight(size_t item, double weight)
+	{
+		if (!validWeight(weight))
+			throw 1;
+
+		size_t container = containerOf(item);
+		unplace(item);
+		itemsWeights_[item] = weight;
+		if (containersWeights_[container] + weight <= containerCapacity_ + capacityTolerance) {
+			place(item, container);
+			updateResidual(container);
+			touch(container);
+		} else {
+			updateResidual(container);
+			touch(container);
+			placeBestFit(item);
+		}
+	}
+
+	void OnlinePacker::placeBestFit(size_t item)
+	{
+		ResidualTree::iterator bestFit = residuals_.lower_bound(itemsWeights_[item] - capacityTolerance);
+		size_t container = (bestFit == residuals_.end()) ? openContainer() : bestFit->second;
+		place(item, container);
+		updateResidual(container);
+		touch(container);
+	}
+
+	void OnlinePacker::countUpdate()
+	{
+		if (repackPeriod_ > 0 && ++updatesSinceRepack_ >= repackPeriod_)
+			repack();
+	}
+
+	void OnlinePacker::repack()
+	{
+		updatesSinceRepack_ = 0;
+
+		++stamp_;
+		std::vector<size_t> window;
+		for (std::deque<size_t>::reverse_iterator i = recentContainers_.rbegin(); i != recentContainers_.rend() && window.size() < repackWindow_; ++i) {
+			if (containerStamps_[*i] != stamp_ && !containerItems_[*i].empty()) {
+				containerStamps_[*i] = stamp_;
+				window.push_back(*i);
+			}
+		}
+		recentContainers_.clear();
+		repackContainers(window);
+	}
+
+	void OnlinePacker::repackContainers(const std::vector<size_t>& window)
+	{
+		if (window.size() < 2)
+			return;
+
+		std::vector<size_t> items;
+		for (size_t j = 0; j < window.size(); ++j)
+			items.insert(items.end(), containerItems_[window[j]].begin(), containerItems_[window[j]].end());
+
+		double* weights = new double[items.size()];
+		bool** matrix = new bool*[items.size()];
+		for (size_t i = 0; i < items.size(); ++i) {
+			weights[i] = itemsWeights_[items[i]];
+			matrix[i] = new bool[window.size()];
+			for (size_t j = 0; j < window.size(); ++j)
+				matrix[i][j] = (itemsContainers_[items[i]] == window[j]);
+		}
+
+		Context context(containerCapacity_, items.size(), weights, 0);
+		ResultInterface* result = hillClimbing(context, new Result(&context, matrix, window.size()), DontLookBits);
+
+		for (size_t i = 0; i < items.size(); ++i)
+			unplace(items[i]);
+
+		for (size_t i = 0; i < items.size(); ++i)
+			place(items[i], window[result->containerOf(i)]);
+
+		for (size_t j = 0; j < window.size(); ++j) {
+			if (containerItems_[window[j]].empty())
+				closeContainer(window[j]);
+			else
+				updateResidual(window[j]);
+		}
+
+		delete result;
+		delete[] weights;
+	}
+
+	size_t OnlinePacker::containersCount() const
+	{
+		return containersCount_;
+	}
+
+	size_t OnlinePacker::itemsCount() const
+	{
+		return itemsCount_;
+	}
+
+	size_t OnlinePacker::containerOf(size_t item) const
+	{
+		if (!contains(item))
+			throw 1;
+		return itemsContainers_[item];
+	}
+
+	double OnlinePacker::containerWeight(size_t container) const
+	{
+		return containersWeights_[container];
+	}
+
+	double OnlinePacker::containerCapacity() const
+	{
+		return containerCapacity_;
+	}
+
+	bool OnlinePacker::contains(size_t item) const
+	{
+		return item < itemsContainers_.size() && itemsContainers_[item] != noContainer;
+	}
+
+	bool OnlinePacker::validWeight(double weight) const
+	{
+		return weight > 0.0 && weight <= containerCapacity_;
+	}
+
+	size_t OnlinePacker::openContainer()
+	{
+		size_t container;
+		if (freeContainers_.empty()) {
+			container = containersWeights_.size();
+			containersWeights_.push_back(0.0);
+			containerItems_.push_back(std::vector<size_t>());
+			containerSlots_.push_back(residuals_.end());
+			containerStamps_.push_back(0);
+		} else {
+			container = freeContainers_.back();
+			freeContainers_.pop_back();
+			containersWeights_[container] = 0.0;
+		}
+		++containersCount_;
+		return container;
+	}
+
+	void OnlinePacker::closeContainer(size_t container)
+	{
+		if (containerSlots_[container] != residuals_.end()) {
+			residuals_.erase(containerSlots_[container]);
+			containerSlots_[container] = residuals_.end();
+		}
+		containersWeights_[container] = 0.0;
+		freeContainers_.push_back(container);
+		--containersCount_;
+	}
+
+	void OnlinePacker::place(size_t item, size_t container)
+	{
+		itemsContainers_[item] = container;
+		itemsPositions_[item] = containerItems_[container].size();
+		containerItems_[container].push_back(item);
+		containersWeights_[container] += itemsWeights_[item];
+	}
+
+	void OnlinePacker::unplace(size_t item)
+	{
+		size_t container = itemsContainers_[item];
+		std::vector<size_t>& contents = containerItems_[container];
+
+		size_t last = contents.back();
+		contents[itemsPositions_[item]] = last;
+		itemsPositions_[last] = itemsPositions_[item];
+		contents.pop_back();
+
+		containersWeights_[container] -= itemsWeights_[item];
+		if (contents.empty())
+			containersWeights_[container] = 0.0;
+	}
+
+	void OnlinePacker::updateResidual(size_t container)
+	{
+		if (containerSlots_[container] != residuals_.end())
+			residuals_.erase(containerSlots_[container]);
+		containerSlots_[container] = residuals_.insert(std::make_pair(containerCapacity_ - containersWeights_[container], container));
+	}
+
+	void OnlinePacker::touch(size_t container)
+	{
+		recentContainers_.push_back(container);
+		if (!batching_ && recentContainers_.size() > 4 * repackWindow_)
+			recentContainers_.pop_front();
+	}
+}
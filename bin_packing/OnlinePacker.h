@@ -0,0 +1,115 @@
+#ifndef ONLINE_PACKER_H
+#define ONLINE_PACKER_H
+
+#include <cstddef>
+#include <map>
+#include <vector>
+#include <deque>
+
+namespace bin_packing
+{
+	class ResultInterface;
+
+	struct PackingUpdate
+	{
+		enum Kind { Insertion, Removal, WeightChange };
+
+		Kind kind;
+		size_t item;
+		double weight;
+	};
+
+	inline PackingUpdate insertion(double weight)
+	{
+		PackingUpdate update = { PackingUpdate::Insertion, 0, weight };
+		return update;
+	}
+
+	inline PackingUpdate removal(size_t item)
+	{
+		PackingUpdate update = { PackingUpdate::Removal, item, 0.0 };
+		return update;
+	}
+
+	inline PackingUpdate weightChange(size_t item, double weight)
+	{
+		PackingUpdate update = { PackingUpdate::WeightChange, item, weight };
+		return update;
+	}
+
+	// Streaming packer: every arriving item goes to the fullest container it
+	// fits in (best fit over a residual capacity tree, O(log m)), and every
+	// repackPeriod updates the recently touched containers are handed to
+	// hillClimbing as a small instance of their own.
+	//
+	// It can also take over a solved packing (item i of its Context becomes
+	// item i here) and re-optimise it after a batch of updates: an item whose
+	// new weight overloads its container is moved out best fit, and then only
+	// the containers the batch touched, together with as many of the
+	// emptiest ones, are repacked. The work depends on the batch, not on the
+	// size of the packing. A batch with an unknown item or a weight that does
+	// not fit is rejected whole, before any of it is applied.
+	class OnlinePacker
+	{
+	public:
+		OnlinePacker(double containerCapacity, size_t repackWindow = 8, size_t repackPeriod = 4096);
+		OnlinePacker(const ResultInterface& result, size_t repackWindow = 8, size_t repackPeriod = 4096);
+
+		size_t insert(double weight);
+		void remove(size_t item);
+		void changeWeight(size_t item, double weight);
+		void repack();
+
+		void update(const std::vector<PackingUpdate>& updates, std::vector<size_t>& insertedItems);
+
+		size_t containersCount() const;
+		size_t itemsCount() const;
+		size_t containerOf(size_t item) const;
+		double containerWeight(size_t container) const;
+		double containerCapacity() const;
+
+	private:
+		typedef std::multimap<double, size_t> ResidualTree;
+
+		size_t insertItem(double weight);
+		void removeItem(size_t item);
+		void changeItemWeight(size_t item, double weight);
+		void placeBestFit(size_t item);
+		void countUpdate();
+		void repackContainers(const std::vector<size_t>& window);
+		bool contains(size_t item) const;
+		bool validWeight(double weight) const;
+
+		size_t openContainer();
+		void closeContainer(size_t container);
+		void place(size_t item, size_t container);
+		void unplace(size_t item);
+		void updateResidual(size_t container);
+		void touch(size_t container);
+
+		double containerCapacity_;
+		size_t repackWindow_;
+		size_t repackPeriod_;
+		size_t updatesSinceRepack_;
+		bool batching_;
+
+		ResidualTree residuals_;
+		std::vector<ResidualTree::iterator> containerSlots_;
+		std::vector<double> containersWeights_;
+		std::vector< std::vector<size_t> > containerItems_;
+		std::vector<size_t> freeContainers_;
+		size_t containersCount_;
+
+		std::vector<double> itemsWeights_;
+		std::vector<size_t> itemsContainers_;
+		std::vector<size_t> itemsPositions_;
+		std::vector<size_t> freeItems_;
+		size_t itemsCount_;
+
+		std::deque<size_t> recentContainers_;
+		std::vector<size_t> containerStamps_;
+		size_t stamp_;
+	};
+}
+
+#endif // ONLINE_PACKER_H
@@ -0,0 +1,204 @@
+#include "Packing.h"
+#include "Context.h"
+
+#include <sstream>
+
+#include <functional>
+#include <algorithm>
+
+namespace bin_packing
+{
+	const size_t Packing::noContainer = static_cast<size_t>(-1);
+
+	static const double epsilon = 1e-9;
+
+	class HeavierItem
+	{
+	public:
+		HeavierItem(const Context* context) : context_(context)
+		{
+		}
+
+		bool operator()(size_t first, size_t second) const
+		{
+			return context_->itemWeight(first) > context_->itemWeight(second);
+		}
+
+	private:
+		const Context* context_;
+	};
+
+	Packing::Packing(const Context* context) : context_(context), itemsContainers_(context->itemsCount(), noContainer),
+		itemsPositions_(context->itemsCount(), 0), containersCount_(0)
+	{
+	}
+
+	void Packing::bestFitDecreasing()
+	{
+		std::vector<size_t> items(context_->itemsCount());
+		for (size_t i = 0; i < items.size(); ++i)
+			items[i] = i;
+		std::sort(items.begin(), items.end(), HeavierItem(context_));
+
+		for (size_t i = 0; i < items.size(); ++i) {
+			size_t container = bestFit(context_->itemWeight(items[i]), context_->containerCapacity(), noContainer);
+			if (container == noContainer)
+				container = openContainer();
+			else
+				unindex(container);
+			place(items[i], container);
+			index(container);
+		}
+	}
+
+	size_t Packing::containersCount() const
+	{
+		return containersCount_;
+	}
+
+	size_t Packing::containerOf(size_t item) const
+	{
+		return itemsContainers_[item];
+	}
+
+	double Packing::containerWeight(size_t container) const
+	{
+		return containersWeights_[container];
+	}
+
+	const std::vector<size_t>& Packing::containerItems(size_t container) const
+	{
+		return containerItems_[container];
+	}
+
+	void Packing::move(size_t item, size_t toContainer)
+	{
+		size_t fromContainer = itemsContainers_[item];
+		if (fromContainer == toContainer)
+			throw 1;
+
+		unindex(fromContainer);
+		unindex(toContainer);
+		unplace(item);
+		place(item, toContainer);
+		index(toContainer);
+
+		if (containerItems_[fromContainer].empty())
+			--containersCount_;
+		else
+			index(fromContainer);
+	}
+
+	void Packing::swap(size_t firstItem, size_t secondItem)
+	{
+		size_t firstContainer = itemsContainers_[firstItem];
+		size_t secondContainer = itemsContainers_[secondItem];
+		if (firstContainer == secondContainer)
+			throw 1;
+
+		unindex(firstContainer);
+		unindex(secondContainer);
+		unplace(firstItem);
+		unplace(secondItem);
+		place(firstItem, secondContainer);
+		place(secondItem, firstContainer);
+		index(firstContainer);
+		index(secondContainer);
+	}
+
+	size_t Packing::bestFit(double weight, double maxResidual, size_t except) const
+	{
+		for (ResidualTree::const_iterator i = residuals_.lower_bound(weight - epsilon); i != residuals_.end() && i->first <= maxResidual + epsilon; ++i) {
+			if (i->second != except)
+				return i->second;
+		}
+		return noContainer;
+	}
+
+	void Packing::emptiestContainers(size_t count, std::vector<size_t>& containers) const
+	{
+		containers.clear();
+		for (FillOrder::const_iterator i = fillOrder_.begin(); i != fillOrder_.end() && containers.size() < count; ++i)
+			containers.push_back(i->second);
+	}
+
+	void Packing::containersBelowResidual(double maxResidual, size_t count, size_t except, std::vector<size_t>& containers) const
+	{
+		containers.clear();
+		ResidualTree::const_iterator i = residuals_.upper_bound(maxResidual + epsilon);
+		while (i != residuals_.begin() && containers.size() < count) {
+			--i;
+			if (i->second != except)
+				containers.push_back(i->second);
+		}
+	}
+
+	std::string Packing::toString() const
+	{
+		std::vector<double> rw;
+		for (FillOrder::const_iterator i = fillOrder_.begin(); i != fillOrder_.end(); ++i)
+			rw.push_back(context_->containerCapacity() - i->first);
+
+		std::stringstream ss;
+		ss << "(" << containersCount_ << ") ";
+		for (size_t i = 0; i < rw.size() && i < 50; ++i)
+			ss << rw[i] << ' ';
+		if (rw.size() > 50)
+			ss << "...";
+
+		return ss.str();
+	}
+
+	const Context* Packing::context() const
+	{
+		return context_;
+	}
+
+	size_t Packing::openContainer()
+	{
+		containersWeights_.push_back(0.0);
+		containerItems_.push_back(std::vector<size_t>());
+		residualSlots_.push_back(residuals_.end());
+		++containersCount_;
+		return containersWeights_.size() - 1;
+	}
+
+	void Packing::place(size_t item, size_t container)
+	{
+		itemsContainers_[item] = container;
+		itemsPositions_[item] = containerItems_[container].size();
+		containerItems_[container].push_back(item);
+		containersWeights_[container] += context_->itemWeight(item);
+	}
+
+	void Packing::unplace(size_t item)
+	{
+		size_t container = itemsContainers_[item];
+		std::vector<size_t>& contents = containerItems_[container];
+
+		size_t last = contents.back();
+		contents[itemsPositions_[item]] = last;
+		itemsPositions_[last] = itemsPositions_[item];
+		contents.pop_back();
+
+		containersWeights_[container] -= context_->itemWeight(item);
+		if (contents.empty())
+			containersWeights_[container] = 0.0;
+		itemsContainers_[item] = noContainer;
+	}
+
+	void Packing::unindex(size_t container)
+	{
+		if (residualSlots_[container] == residuals_.end())
+			return;
+		residuals_.erase(residualSlots_[container]);
+		residualSlots_[container] = residuals_.end();
+		fillOrder_.erase(std::make_pair(containersWeights_[container], container));
+	}
+
+	void Packing::index(size_t container)
+	{
+		residualSlots_[container] = residuals_.insert(std::make_pair(context_->containerCapacity() - containersWeights_[container], container));
+		fillOrder_.insert(std::make_pair(containersWeights_[container], container));
+	}
+}
@@ -0,0 +1,68 @@
+#ifndef PACKING_H
+#define PACKING_H
+
+#include <cstddef>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace bin_packing
+{
+	class Context;
+
+	// Item -> container assignment that needs O(n + m) memory instead of the
+	// n x m matrix of Result. Containers are indexed by residual capacity
+	// (for best fit) and by weight (for picking the emptiest ones), so both
+	// queries and updates are O(log m). Emptied containers keep their index
+	// and are simply dropped from the indexes.
+	class Packing
+	{
+	public:
+		static const size_t noContainer;
+
+		Packing(const Context* context);
+
+		void bestFitDecreasing();
+
+		size_t containersCount() const;
+		size_t containerOf(size_t item) const;
+		double containerWeight(size_t container) const;
+		const std::vector<size_t>& containerItems(size_t container) const;
+
+		void move(size_t item, size_t toContainer);
+		void swap(size_t firstItem, size_t secondItem);
+
+		size_t bestFit(double weight, double maxResidual, size_t except) const;
+		void emptiestContainers(size_t count, std::vector<size_t>& containers) const;
+		void containersBelowResidual(double maxResidual, size_t count, size_t except, std::vector<size_t>& containers) const;
+
+		std::string toString() const;
+		const Context* context() const;
+
+	private:
+		typedef std::multimap<double, size_t> ResidualTree;
+		typedef std::set< std::pair<double, size_t> > FillOrder;
+
+		size_t openContainer();
+		void place(size_t item, size_t container);
+		void unplace(size_t item);
+		void unindex(size_t container);
+		void index(size_t container);
+
+		const Context* context_;
+
+		std::vector<size_t> itemsContainers_;
+		std::vector<size_t> itemsPositions_;
+
+		std::vector<double> containersWeights_;
+		std::vector< std::vector<size_t> > containerItems_;
+		size_t containersCount_;
+
+		ResidualTree residuals_;
+		std::vector<ResidualTree::iterator> residualSlots_;
+		FillOrder fillOrder_;
+	};
+}
+
+#endif // PACKING_H
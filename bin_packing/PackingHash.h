@@ -0,0 +1,24 @@
+#ifndef PACKING_HASH_H
+#define PACKING_HASH_H
+
+namespace bin_packing
+{
+	// Zobrist-style hash of a packing. Every weight class has a random 64-bit
+	// key, a container hashes to the sum of its items' class keys and the
+	// packing to the sum of its mixed container hashes. Sums instead of xors
+	// keep repeated classes from cancelling out, and since neither the
+	// container labels nor the items of a class matter, packings that differ
+	// only by symmetry hash the same. Relocating an item changes two terms,
+	// so Result keeps the hash up to date in O(1) per relocation.
+	typedef unsigned long long PackingHash;
+
+	inline PackingHash mixBits(PackingHash value)
+	{
+		value += 0x9E3779B97F4A7C15ULL;
+		value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+		return value ^ (value >> 31);
+	}
+}
+
+#endif // PACKING_HASH_H
@@ -0,0 +1,53 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include "PackingHash.h"
+
+#include <cstddef>
+
+namespace bin_packing
+{
+	// SplitMix64 stream of random numbers. Every Context owns one, so
+	// searches on different threads never share the state of std::rand, and
+	// the state is a single number that checkpoints can store as it is.
+	class Random
+	{
+	public:
+		explicit Random(unsigned long long seed = 0) : state_(seed)
+		{
+		}
+
+		void seed(unsigned long long seed)
+		{
+			state_ = seed;
+		}
+
+		unsigned long long state() const
+		{
+			return state_;
+		}
+
+		unsigned long long next()
+		{
+			state_ += 0x9E3779B97F4A7C15ULL;
+			return mixBits(state_);
+		}
+
+		// Uniform in [0, bound), up to a bias of bound / 2^64.
+		size_t below(size_t bound)
+		{
+			return static_cast<size_t>(next() % bound);
+		}
+
+		// Uniform in [0, 1).
+		double unit()
+		{
+			return static_cast<double>(next() >> 11) / 9007199254740992.0;
+		}
+
+	private:
+		unsigned long long state_;
+	};
+}
+
+#endif // RANDOM_H
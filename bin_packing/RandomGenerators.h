@@ -1,17 +1,58 @@
 #include <vector>
-#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+
+#include "SubsetSum.h"
+#include "Resources.h"
+#include "ConflictGraph.h"
+#include "Random.h"
 
 namespace bin_packing
 {
 	class RandomGenerator {
 	public:
-		RandomGenerator(size_t itemsCount, double* items, double containerCapacity) : itemsCount_(itemsCount), items_(items), containerCapacity_(containerCapacity)
+		RandomGenerator(size_t itemsCount, double* items, double containerCapacity) : itemsCount_(itemsCount), items_(items), containerCapacity_(containerCapacity), conflicts_(0),
+			random_(0)
 		{
 		}
 
 		virtual void generate(bool**& matrix, size_t& containersCount) const = 0;
 
+		// Items that conflict are never put into the same container.
+		void setConflicts(const ConflictGraph* conflicts)
+		{
+			conflicts_ = conflicts;
+		}
+
+		// Must be set before generating with random choices.
+		void setRandom(Random& random)
+		{
+			random_ = &random;
+		}
+
 	protected:
+		// Occupancy bitsets of the containers built so far, one row of the
+		// conflict graph's width per container; unused without conflicts.
+		bool conflictsWith(size_t item, const std::vector<ConflictWord>& occupancy, size_t container) const
+		{
+			return conflicts_ != 0 && conflicts_->conflictsWith(item, &occupancy[container * conflicts_->wordsCount()]);
+		}
+
+		void occupy(std::vector<ConflictWord>& occupancy, size_t item, size_t container) const
+		{
+			if (conflicts_ == 0)
+				return;
+			size_t wordsCount = conflicts_->wordsCount();
+			if (occupancy.size() < (container + 1) * wordsCount)
+				occupancy.resize((container + 1) * wordsCount, 0);
+			ConflictGraph::insert(&occupancy[container * wordsCount], item);
+		}
+
+		bool conflicts(size_t first, size_t second) const
+		{
+			return conflicts_ != 0 && conflicts_->conflicts(first, second);
+		}
+
 		bool** generateEmptyMatrix() const 
 		{
 			bool** matrix = new bool*[itemsCount_];
@@ -39,10 +80,17 @@ namespace bin_packing
 			return containerCapacity_;
 		}
 
+		Random& random() const
+		{
+			return *random_;
+		}
+
 	private:
 		size_t itemsCount_;
 		double* items_;
 		double containerCapacity_;
+		const ConflictGraph* conflicts_;
+		Random* random_;
 	};
 
 	class WorstRandomGenerator : public RandomGenerator{
@@ -71,14 +119,16 @@ namespace bin_packing
 			matrix = generateEmptyMatrix();
 
 			std::vector<double> containers;
+			std::vector<ConflictWord> occupancy;
 			for (size_t i = 0; i < itemsCount(); ++i) {
 				bool found = false;
 				for (size_t j = 0; j < containers.size(); ++j) {
-					bool itemFits = (containers[j] - itemWeight(i) >= 0);
-					bool randomize = !useRandom_ || static_cast<double>(std::rand()) / RAND_MAX > 0.5;
+					bool itemFits = (containers[j] - itemWeight(i) >= 0) && !conflictsWith(i, occupancy, j);
+					bool randomize = !useRandom_ || random().unit() > 0.5;
 					if (itemFits && randomize) {
 						containers[j] -= itemWeight(i);
 						matrix[i][j] = true;
+						occupy(occupancy, i, j);
 						found = true;
 						break;
 					}
@@ -88,6 +138,7 @@ namespace bin_packing
 					containers.push_back(containerCapacity());
 					containers[containers.size() - 1] -= itemWeight(i);
 					matrix[i][containers.size() - 1] = true;
+					occupy(occupancy, i, containers.size() - 1);
 				}
 			}
 
@@ -97,4 +148,162 @@ namespace bin_packing
 	private:
 		bool useRandom_;
 	};
+
+	// Random first fit for vector packing: an item goes into a container only
+	// when every resource row entry stays within capacity.
+	class VectorFFGenerator : public RandomGenerator {
+	public:
+		VectorFFGenerator(size_t itemsCount, double* items, double containerCapacity, const double* resources, size_t stride) : RandomGenerator(itemsCount, items, containerCapacity),
+			resources_(resources), stride_(stride)
+		{
+		}
+
+		virtual void generate(bool**& matrix, size_t& containersCount) const
+		{
+			matrix = generateEmptyMatrix();
+
+			std::vector<double> loads;
+			std::vector<ConflictWord> occupancy;
+			containersCount = 0;
+			for (size_t i = 0; i < itemsCount(); ++i) {
+				const double* item = resources_ + i * stride_;
+				size_t container = containersCount;
+				for (size_t j = 0; j < containersCount; ++j) {
+					if (rowFits(&loads[j * stride_], item, stride_) && !conflictsWith(i, occupancy, j) && random().unit() > 0.5) {
+						container = j;
+						break;
+					}
+				}
+
+				if (container == containersCount)
+					loads.resize(++containersCount * stride_, 0.0);
+				addRow(&loads[container * stride_], item, stride_);
+				matrix[i][container] = true;
+				occupy(occupancy, i, container);
+			}
+		}
+
+	private:
+		const double* resources_;
+		size_t stride_;
+	};
+
+	// Minimum bin slack constructor (MBS'): every container starts with the
+	// largest remaining item and is filled up with the subset of the other
+	// remaining items that leaves the least slack, found by the bitset
+	// subset-sum DP, which prefers the earliest, i.e. largest, candidates.
+	// Weights are turned into fixed point first, exactly when a power of ten
+	// makes them integral (one decimal for the triplet instances), otherwise
+	// rounded up against a rounded down capacity. The fixed point capacity
+	// never exceeds 2^16, scaling large capacities down, so the DP stays
+	// small. A weight within rounding
+	// noise of a decimal counts as that decimal, so a chosen item still only
+	// joins a container while the double weights fit. With useRandom some
+	// neighbouring candidates swap places, so repeated calls give different
+	// packings of about the same quality.
+	// The subset sum knows nothing of conflicts: candidates that conflict
+	// with the largest item are left out, and a chosen item that conflicts
+	// with one placed before it stays for a later container.
+	// The same tolerance Context::fits allows.
+	static const double mbsCapacityTolerance = 1e-9;
+
+	class MBSGenerator : public RandomGenerator {
+	public:
+		MBSGenerator(size_t itemsCount, double* items, double containerCapacity, bool useRandom = true) : RandomGenerator(itemsCount, items, containerCapacity), useRandom_(useRandom)
+		{
+		}
+
+		virtual void generate(bool**& matrix, size_t& containersCount) const
+		{
+			matrix = generateEmptyMatrix();
+
+			std::vector<size_t> weights;
+			size_t capacity;
+			fixedPointWeights(weights, capacity);
+
+			std::vector< std::pair<size_t, size_t> > remaining;
+			for (size_t i = 0; i < itemsCount(); ++i)
+				remaining.push_back(std::make_pair(weights[i], i));
+			std::sort(remaining.begin(), remaining.end(), std::greater< std::pair<size_t, size_t> >());
+
+			std::vector< std::pair<size_t, size_t> > candidates;
+			std::vector<size_t> candidatesWeights;
+			std::vector<bool> chosen;
+			std::vector<ConflictWord> occupancy;
+			containersCount = 0;
+			while (!remaining.empty()) {
+				size_t largest = remaining[0].second;
+				matrix[largest][containersCount] = true;
+
+				occupancy.clear();
+				occupy(occupancy, largest, 0);
+				double load = itemWeight(largest);
+
+				size_t residual = capacity > weights[largest] ? capacity - weights[largest] : 0;
+				candidates.clear();
+				for (size_t r = 1; r < remaining.size(); ++r)
+					if (remaining[r].first <= residual && !conflicts(largest, remaining[r].second))
+						candidates.push_back(remaining[r]);
+				if (useRandom_)
+					for (size_t r = 1; r < candidates.size(); ++r)
+						if (random().below(4) == 0)
+							std::swap(candidates[r - 1], candidates[r]);
+
+				candidatesWeights.resize(candidates.size());
+				for (size_t r = 0; r < candidates.size(); ++r)
+					candidatesWeights[r] = candidates[r].first;
+				SubsetSum subsetSum(residual);
+				subsetSum.solve(candidatesWeights, chosen);
+				for (size_t r = 0; r < candidates.size(); ++r) {
+					size_t item = candidates[r].second;
+					if (chosen[r] && load + itemWeight(item) <= containerCapacity() + mbsCapacityTolerance && !conflictsWith(item, occupancy, 0)) {
+						matrix[item][containersCount] = true;
+						occupy(occupancy, item, 0);
+						load += itemWeight(item);
+					}
+				}
+
+				size_t kept = 0;
+				for (size_t r = 1; r < remaining.size(); ++r)
+					if (!matrix[remaining[r].second][containersCount])
+						remaining[kept++] = remaining[r];
+				remaining.resize(kept);
+				++containersCount;
+			}
+		}
+
+	private:
+		static const size_t maxFixedPointCapacity = 1 << 16;
+
+		void fixedPointWeights(std::vector<size_t>& weights, size_t& capacity) const
+		{
+			double scale = 1.0;
+			bool exact = false;
+			for (;;) {
+				exact = integral(containerCapacity() * scale);
+				for (size_t i = 0; exact && i < itemsCount(); ++i)
+					exact = integral(itemWeight(i) * scale);
+				if (exact || containerCapacity() * scale * 10.0 > maxFixedPointCapacity)
+					break;
+				scale *= 10.0;
+			}
+			if (containerCapacity() * scale > maxFixedPointCapacity) {
+				scale = maxFixedPointCapacity / containerCapacity();
+				exact = false;
+			}
+
+			double slack = exact ? 0.5 : 0.0;
+			capacity = static_cast<size_t>(std::floor(containerCapacity() * scale + slack));
+			weights.resize(itemsCount());
+			for (size_t i = 0; i < itemsCount(); ++i)
+				weights[i] = static_cast<size_t>(std::ceil(itemWeight(i) * scale - slack));
+		}
+
+		static bool integral(double value)
+		{
+			return std::fabs(value - std::floor(value + 0.5)) < 1e-9;
+		}
+
+		bool useRandom_;
+	};
 }
\ No newline at end of file
@@ -0,0 +1,83 @@
+#ifndef RESOURCES_H
+#define RESOURCES_H
+
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BIN_PACKING_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace bin_packing
+{
+	// Vector packing keeps the resources of every item and the loads of
+	// every container as rows of doubles, scaled so that each capacity is 1
+	// and padded with zeros to a whole number of SSE2 registers, so a row
+	// is checked or updated two dimensions per instruction and the cost of
+	// a move grows with the number of dimensions only through a few packed
+	// operations.
+	static const double resourceTolerance = 1e-9;
+
+	inline size_t resourcesStride(size_t dimensionsCount)
+	{
+		return (dimensionsCount + 1) & ~static_cast<size_t>(1);
+	}
+
+	// Does a container with the given load still fit after adding the
+	// item row?
+	inline bool rowFits(const double* load, const double* item, size_t stride)
+	{
+#ifdef BIN_PACKING_SSE2
+		const __m128d limit = _mm_set1_pd(1.0 + resourceTolerance);
+		__m128d overloaded = _mm_setzero_pd();
+		for (size_t k = 0; k < stride; k += 2)
+			overloaded = _mm_or_pd(overloaded, _mm_cmpgt_pd(_mm_add_pd(_mm_loadu_pd(load + k), _mm_loadu_pd(item + k)), limit));
+		return _mm_movemask_pd(overloaded) == 0;
+#else
+		bool overloaded = false;
+		for (size_t k = 0; k < stride; ++k)
+			overloaded |= load[k] + item[k] > 1.0 + resourceTolerance;
+		return !overloaded;
+#endif
+	}
+
+	inline bool rowFits(const double* load, size_t stride)
+	{
+#ifdef BIN_PACKING_SSE2
+		const __m128d limit = _mm_set1_pd(1.0 + resourceTolerance);
+		__m128d overloaded = _mm_setzero_pd();
+		for (size_t k = 0; k < stride; k += 2)
+			overloaded = _mm_or_pd(overloaded, _mm_cmpgt_pd(_mm_loadu_pd(load + k), limit));
+		return _mm_movemask_pd(overloaded) == 0;
+#else
+		bool overloaded = false;
+		for (size_t k = 0; k < stride; ++k)
+			overloaded |= load[k] > 1.0 + resourceTolerance;
+		return !overloaded;
+#endif
+	}
+
+	inline void addRow(double* load, const double* item, size_t stride)
+	{
+#ifdef BIN_PACKING_SSE2
+		for (size_t k = 0; k < stride; k += 2)
+			_mm_storeu_pd(load + k, _mm_add_pd(_mm_loadu_pd(load + k), _mm_loadu_pd(item + k)));
+#else
+		for (size_t k = 0; k < stride; ++k)
+			load[k] += item[k];
+#endif
+	}
+
+	inline void subtractRow(double* load, const double* item, size_t stride)
+	{
+#ifdef BIN_PACKING_SSE2
+		for (size_t k = 0; k < stride; k += 2)
+			_mm_storeu_pd(load + k, _mm_sub_pd(_mm_loadu_pd(load + k), _mm_loadu_pd(item + k)));
+#else
+		for (size_t k = 0; k < stride; ++k)
+			load[k] -= item[k];
+#endif
+	}
+}
+
+#endif // RESOURCES_H
@@ -1,9 +1,7 @@
 #include "Result.h"
 #include "Context.h"
-#include "Range.h"
-#include "MoveResult.h"
-#include "SwapResult.h"
 #include "Clone.h"
+#include "Resources.h"
 
 #include <vector>
 #include <sstream>
@@ -13,27 +11,83 @@
 
 namespace bin_packing
 {
-	Result::Result(const Context* context, bool** matrix, size_t containersCount, double* containersWeights) : context_(context), matrix_(matrix), containersWeights_(containersWeights), containersCount_(containersCount)
+	Result::Result(const Context* context, bool** matrix, size_t containersCount, double* containersWeights) : slotsCount_(containersCount),
+		containersWeights_(containersWeights), containersResources_(0), containersOccupancy_(0), containersCount_(containersCount), context_(context)
 	{
 		// std::cout << "Created" << std::endl;
-		if (containersWeights_ == 0) {
+		bool computeWeights = (containersWeights_ == 0);
+		if (computeWeights)
 			containersWeights_ = new double[containersCount_];
-			for (size_t j = 0; j < containersCount_; ++j) {
+
+		size_t itemsCount = context_->itemsCount();
+		containersSizes_ = new size_t[containersCount_];
+		itemsSlots_ = new size_t[itemsCount];
+		containersSlots_ = new size_t[containersCount_];
+		slotsContainers_ = new size_t[containersCount_];
+		containersHashes_ = new PackingHash[containersCount_];
+		hash_ = 0;
+		for (size_t j = 0; j < containersCount_; ++j) {
+			if (computeWeights)
 				containersWeights_[j] = 0.0;
-				for (size_t i = 0; i < context_->itemsCount(); ++i) {
-					if (matrix_[i][j])
-						containersWeights_[j] += context_->itemWeight(i);
-				}
-			}
+			containersSizes_[j] = 0;
+			containersSlots_[j] = j;
+			slotsContainers_[j] = j;
+			containersHashes_[j] = 0;
+		}
+		for (size_t i = 0; i < itemsCount; ++i) {
+			size_t j = std::find(matrix[i], matrix[i] + containersCount_, true) - matrix[i];
+			if (computeWeights)
+				containersWeights_[j] += context_->itemWeight(i);
+			++containersSizes_[j];
+			itemsSlots_[i] = j;
+			containersHashes_[j] += context_->classKey(context_->itemClass(i));
+		}
+		for (size_t j = 0; j < containersCount_; ++j)
+			hash_ += mixBits(containersHashes_[j]);
+
+		for (size_t i = 0; i < itemsCount; ++i)
+			delete[] matrix[i];
+		delete[] matrix;
+
+		size_t stride = context_->resourcesStride();
+		if (stride != 0) {
+			containersResources_ = new double[containersCount_ * stride];
+			std::fill(containersResources_, containersResources_ + containersCount_ * stride, 0.0);
+			for (size_t i = 0; i < itemsCount; ++i)
+				addRow(containersResources_ + itemsSlots_[i] * stride, context_->itemResources(i), stride);
+		}
+
+		if (!context_->conflicts().empty()) {
+			size_t wordsCount = context_->conflicts().wordsCount();
+			containersOccupancy_ = new ConflictWord[containersCount_ * wordsCount];
+			std::fill(containersOccupancy_, containersOccupancy_ + containersCount_ * wordsCount, 0);
+			for (size_t i = 0; i < itemsCount; ++i)
+				ConflictGraph::insert(containersOccupancy_ + itemsSlots_[i] * wordsCount, i);
 		}
 	}
 
+	Result::Result(const Result& other) : slotsCount_(other.slotsCount_), containersWeights_(::clone(other.containersWeights_, other.slotsCount_)),
+		containersResources_(0), containersOccupancy_(0), containersCount_(other.containersCount_), containersSizes_(::clone(other.containersSizes_, other.slotsCount_)),
+		itemsSlots_(::clone(other.itemsSlots_, other.context_->itemsCount())), containersSlots_(::clone(other.containersSlots_, other.slotsCount_)),
+		slotsContainers_(::clone(other.slotsContainers_, other.slotsCount_)), containersHashes_(::clone(other.containersHashes_, other.slotsCount_)), hash_(other.hash_),
+		context_(other.context_)
+	{
+		if (other.containersResources_ != 0)
+			containersResources_ = ::clone(other.containersResources_, slotsCount_ * context_->resourcesStride());
+		if (other.containersOccupancy_ != 0)
+			containersOccupancy_ = ::clone(other.containersOccupancy_, slotsCount_ * context_->conflicts().wordsCount());
+	}
+
 	Result::~Result() {
 		// std::cout << "Deleted" << std::endl;
 		delete[] containersWeights_;
-		for (size_t j = 0; j < context_->itemsCount(); ++j)
-			delete[] matrix_[j];
-		delete[] matrix_;
+		delete[] containersResources_;
+		delete[] containersOccupancy_;
+		delete[] containersSizes_;
+		delete[] itemsSlots_;
+		delete[] containersSlots_;
+		delete[] slotsContainers_;
+		delete[] containersHashes_;
 	}
 
 	const Context* Result::context() const
@@ -43,36 +97,7 @@ namespace bin_packing
 
 	ResultInterface* Result::clone() const
 	{
-		return new Result(context_, ::clone(matrix_, context_->itemsCount(), containersCount_), containersCount_/*, ::clone(containersWeights_, containersCount_)*/);
-	}
-
-	Result::NeighbourRange* Result::neighbours() const
-	{
-		bool useSwaps = true;
-		std::vector<ResultInterface*> neighbours;
-		for (size_t i = 0; i < context_->itemsCount(); ++i) {
-			for (size_t j = 0; j < containersCount_; ++j) {
-				try {
-					ResultInterface* result = move(i, j);
-					if (result->containersCount() < containersCount_)
-						useSwaps = false;
-					neighbours.push_back(result);
-				} catch (int&) {
-				}
-			}
-		}
-
-		if (useSwaps) {
-			for (size_t i = 0; i < context_->itemsCount(); ++i) {
-				for (size_t j = i + 1; j < context_->itemsCount(); ++j) {
-					try {
-						neighbours.push_back(swap(i, j));
-					} catch (int&) {
-					}
-				}
-			}
-		}
-		return new NeighbourRange(neighbours);
+		return new Result(*this);
 	}
 
 	size_t Result::containersCount() const
@@ -85,51 +110,14 @@ namespace bin_packing
 		return containersWeights_;
 	}
 
-	ResultInterface* Result::move(size_t item, size_t toContainer) const
+	const double* Result::containersResources() const
 	{
-		checkContainerWeight(containersWeights_[toContainer] + context_->itemWeight(item));
-		size_t fromContainer = findItem(item);
-		if (fromContainer == toContainer)
-			throw 1;
-
-		return new MoveResult(this, item, fromContainer, toContainer);
-	}
-
-	bool** Result::copyMatrix() const {
-		size_t itemsCount = context_->itemsCount();
-		bool** matrix = new bool*[itemsCount];
-		for (size_t i = 0; i < itemsCount; ++i) {
-			matrix[i] = new bool[containersCount_];
-			for (size_t j = 0; j < containersCount_; ++j)
-				matrix[i][j] = matrix_[i][j];
-		}
-		return matrix;
-	}
-
-	ResultInterface* Result::swap(size_t firstItem, size_t secondItem) const {
-		size_t firstContainer = findItem(firstItem);
-		size_t secondContainer = findItem(secondItem);
-		if (firstContainer == secondContainer || firstItem == secondItem || context_->itemWeight(secondItem) == context_->itemWeight(firstItem))
-			throw 1;
-		checkContainerWeight(containersWeights_[firstContainer] + context_->itemWeight(secondItem) - context_->itemWeight(firstItem));
-		checkContainerWeight(containersWeights_[secondContainer] + context_->itemWeight(firstItem) - context_->itemWeight(secondItem));
-
-		return new SwapResult(this, firstItem, firstContainer, secondItem, secondContainer);
+		return containersResources_;
 	}
 
-	void Result::checkContainerWeight(double weight) const
+	const ConflictWord* Result::containersOccupancy() const
 	{
-		if (weight > context_->containerCapacity())
-			throw 1;
-	}
-
-	size_t Result::findItem(size_t item) const
-	{
-		for (size_t i = 0; i < containersCount_; ++i) {
-			if (matrix_[item][i])
-				return i;
-		}
-		throw 1;//std::exception();
+		return containersOccupancy_;
 	}
 
 	std::string Result::toString() const {
@@ -155,7 +143,7 @@ namespace bin_packing
 			ss.width(5);
 			ss << i << ": ";
 			for (size_t j = 0; j < context_->itemsCount(); ++j) {
-				if (matrix_[j][i]) {
+				if (containerOf(j) == i) {
 					ss.width(5);
 					ss << j << ' ';
 				}
@@ -165,18 +153,99 @@ namespace bin_packing
 		return ss.str();
 	}
 
-	const bool * const * Result::matrix() const
+	void Result::apply(Move& move)
+	{
+		move.deletedContainer = false;
+		for (size_t k = 0; k < move.length; ++k)
+			relocate(move.items[k], move.fromContainers[k], move.toContainers[k]);
+
+		if (containersSizes_[move.fromContainers[0]] == 0) {
+			deleteContainer(move.fromContainers[0]);
+			move.deletedContainer = true;
+		}
+	}
+
+	void Result::undo(const Move& move)
+	{
+		if (move.deletedContainer)
+			restoreContainer(move.fromContainers[0]);
+		for (size_t k = move.length; k > 0; --k)
+			relocate(move.items[k - 1], move.toContainers[k - 1], move.fromContainers[k - 1]);
+	}
+
+	size_t Result::containerOf(size_t item) const
+	{
+		return slotsContainers_[itemsSlots_[item]];
+	}
+
+	PackingHash Result::hash() const
 	{
-		return matrix_;
+		return hash_;
 	}
 
-    std::vector< std::pair<size_t, size_t> > Result::notAllowedToSet() const
-    {
-        return std::vector< std::pair<size_t, size_t> >();
-    }
+	void Result::relocate(size_t item, size_t fromContainer, size_t toContainer)
+	{
+		itemsSlots_[item] = containersSlots_[toContainer];
+
+		containersWeights_[fromContainer] -= context_->itemWeight(item);
+		containersWeights_[toContainer] += context_->itemWeight(item);
+		if (--containersSizes_[fromContainer] == 0)
+			containersWeights_[fromContainer] = 0.0;
+		++containersSizes_[toContainer];
+
+		size_t stride = context_->resourcesStride();
+		if (stride != 0) {
+			subtractRow(containersResources_ + fromContainer * stride, context_->itemResources(item), stride);
+			addRow(containersResources_ + toContainer * stride, context_->itemResources(item), stride);
+			if (containersSizes_[fromContainer] == 0)
+				std::fill(containersResources_ + fromContainer * stride, containersResources_ + (fromContainer + 1) * stride, 0.0);
+		}
+		if (containersOccupancy_ != 0) {
+			size_t wordsCount = context_->conflicts().wordsCount();
+			ConflictGraph::remove(containersOccupancy_ + fromContainer * wordsCount, item);
+			ConflictGraph::insert(containersOccupancy_ + toContainer * wordsCount, item);
+		}
+
+		PackingHash key = context_->classKey(context_->itemClass(item));
+		hash_ -= mixBits(containersHashes_[fromContainer]) + mixBits(containersHashes_[toContainer]);
+		containersHashes_[fromContainer] -= key;
+		containersHashes_[toContainer] += key;
+		hash_ += mixBits(containersHashes_[fromContainer]) + mixBits(containersHashes_[toContainer]);
+	}
 
-    bool Result::deletedContainer(size_t& containter) const
-    {
-        return false;
-    }
+	// The emptied container trades places with the last one, which keeps its
+	// slot and so its items; restoring it trades them back.
+	void Result::deleteContainer(size_t container)
+	{
+		size_t last = --containersCount_;
+		hash_ -= mixBits(0);
+		if (container != last)
+			swapContainers(container, last);
+	}
+
+	void Result::restoreContainer(size_t container)
+	{
+		size_t last = containersCount_++;
+		hash_ += mixBits(0);
+		if (container != last)
+			swapContainers(container, last);
+	}
+
+	void Result::swapContainers(size_t first, size_t second)
+	{
+		std::swap(containersSlots_[first], containersSlots_[second]);
+		slotsContainers_[containersSlots_[first]] = first;
+		slotsContainers_[containersSlots_[second]] = second;
+
+		std::swap(containersWeights_[first], containersWeights_[second]);
+		std::swap(containersSizes_[first], containersSizes_[second]);
+		std::swap(containersHashes_[first], containersHashes_[second]);
+		size_t stride = context_->resourcesStride();
+		if (stride != 0)
+			std::swap_ranges(containersResources_ + first * stride, containersResources_ + (first + 1) * stride, containersResources_ + second * stride);
+		if (containersOccupancy_ != 0) {
+			size_t wordsCount = context_->conflicts().wordsCount();
+			std::swap_ranges(containersOccupancy_ + first * wordsCount, containersOccupancy_ + (first + 1) * wordsCount, containersOccupancy_ + second * wordsCount);
+		}
+	}
 }
\ No newline at end of file
@@ -7,16 +7,22 @@ namespace bin_packing
 {
 	class Context;
 
+	// Items are indexed by the slot of their container, and containers map
+	// to slots and back, so deleting a container swaps two slots instead of
+	// renumbering the items of the last one. The matrix passed in is only
+	// read once and freed.
 	class Result : public ResultInterface
 	{
 	public:
 		Result(const Context* context, bool** matrix, size_t containersCount, double* containersWeights = 0);
-		
+		Result(const Result& other);
+
 		virtual ~Result();
-		virtual NeighbourRange* neighbours() const;
 
 		virtual size_t containersCount() const;
 		virtual const double* containersWeights() const;
+		virtual const double* containersResources() const;
+		virtual const ConflictWord* containersOccupancy() const;
 
 		virtual std::string toString() const;
 		virtual std::string toGeneralString() const;
@@ -24,23 +30,30 @@ namespace bin_packing
 		virtual const Context* context() const;
 		virtual ResultInterface* clone() const;
 
-		virtual const bool * const * matrix() const;
-
-        std::vector< std::pair<size_t, size_t> > notAllowedToSet() const;
-        bool deletedContainer(size_t& containter) const;
+		void apply(Move& move);
+		void undo(const Move& move);
+		size_t containerOf(size_t item) const;
+		PackingHash hash() const;
 
 	private:
-		bool** copyMatrix() const;
-
-		ResultInterface* move(size_t item, size_t toContainer) const;
-		ResultInterface* swap(size_t firstItem, size_t secondItem) const;
+		void relocate(size_t item, size_t fromContainer, size_t toContainer);
+		void deleteContainer(size_t container);
+		void restoreContainer(size_t container);
+		void swapContainers(size_t first, size_t second);
 
-		void checkContainerWeight(double weight) const;
-		size_t findItem(size_t item) const;
+		Result& operator=(const Result&);
 
-		bool** matrix_;
+		size_t slotsCount_;
 		double* containersWeights_;
+		double* containersResources_;
+		ConflictWord* containersOccupancy_;
 		size_t containersCount_;
+		size_t* containersSizes_;
+		size_t* itemsSlots_;
+		size_t* containersSlots_;
+		size_t* slotsContainers_;
+		PackingHash* containersHashes_;
+		PackingHash hash_;
 
 		const Context* context_;
 	};
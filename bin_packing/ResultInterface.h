@@ -4,21 +4,23 @@
 #include <string>
 #include <vector>
 
+#include "Move.h"
+#include "PackingHash.h"
+#include "ConflictGraph.h"
+
 namespace bin_packing
 {
 	class Context;
-	class Range;
 
 	class ResultInterface
 	{
 	public:
-		typedef Range NeighbourRange;
-
 		virtual ~ResultInterface() {};
-		virtual NeighbourRange* neighbours() const = 0;
 
 		virtual size_t containersCount() const = 0;
 		virtual const double* containersWeights() const = 0;
+		virtual const double* containersResources() const = 0;
+		virtual const ConflictWord* containersOccupancy() const = 0;
 
 		virtual std::string toString() const = 0;
 		virtual std::string toGeneralString() const = 0;
@@ -27,10 +29,10 @@ namespace bin_packing
 
 		virtual const Context* context() const = 0;
 
-		virtual const bool * const * matrix() const = 0;
-
-        virtual std::vector< std::pair<size_t, size_t> > notAllowedToSet() const = 0;
-        virtual bool deletedContainer(size_t& containter) const = 0;
+		virtual void apply(Move& move) = 0;
+		virtual void undo(const Move& move) = 0;
+		virtual size_t containerOf(size_t item) const = 0;
+		virtual PackingHash hash() const = 0;
 	};
 }
 
@@ -0,0 +1,228 @@
+#include "Serialization.h"
+#include "Context.h"
+#include "ResultInterface.h"
+#include "Result.h"
+#include "Move.h"
+#include "Clone.h"
+
+#include <istream>
+#include <ostream>
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+namespace bin_packing
+{
+	void writeNumber(std::ostream& stream, unsigned long long value)
+	{
+		while (value >= 0x80) {
+			stream.put(static_cast<char>((value & 0x7F) | 0x80));
+			value >>= 7;
+		}
+		stream.put(static_cast<char>(value));
+	}
+
+	unsigned long long readNumber(std::istream& stream)
+	{
+		unsigned long long value = 0;
+		for (size_t shift = 0; shift < 64; shift += 7) {
+			int byte = stream.get();
+			if (byte == std::istream::traits_type::eof())
+				throw 1;
+			value |= static_cast<unsigned long long>(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0)
+				return value;
+		}
+		throw 1;
+	}
+
+	size_t readSize(std::istream& stream)
+	{
+		return static_cast<size_t>(readNumber(stream));
+	}
+
+	void writeDouble(std::ostream& stream, double value)
+	{
+		stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	double readDouble(std::istream& stream)
+	{
+		double value;
+		if (!stream.read(reinterpret_cast<char*>(&value), sizeof(value)))
+			throw 1;
+		return value;
+	}
+
+	void writeSizes(std::ostream& stream, const std::vector<size_t>& values)
+	{
+		writeNumber(stream, values.size());
+		for (size_t i = 0; i < values.size(); ++i)
+			writeNumber(stream, values[i]);
+	}
+
+	void readSizes(std::istream& stream, std::vector<size_t>& values, size_t maxCount)
+	{
+		size_t count = readSize(stream);
+		if (count > maxCount)
+			throw 1;
+		values.resize(count);
+		for (size_t i = 0; i < values.size(); ++i)
+			values[i] = readSize(stream);
+	}
+
+	void writeResult(std::ostream& stream, const ResultInterface& result)
+	{
+		size_t itemsCount = result.context()->itemsCount();
+		writeNumber(stream, itemsCount);
+		writeNumber(stream, result.containersCount());
+		for (size_t i = 0; i < itemsCount; ++i)
+			writeNumber(stream, result.containerOf(i));
+		for (size_t c = 0; c < result.containersCount(); ++c)
+			writeDouble(stream, result.containersWeights()[c]);
+	}
+
+	static const double weightTolerance = 1e-6;
+
+	static bool** emptyMatrix(size_t itemsCount, size_t containersCount)
+	{
+		bool** matrix = new bool*[itemsCount];
+		for (size_t i = 0; i < itemsCount; ++i) {
+			matrix[i] = new bool[containersCount];
+			std::fill(matrix[i], matrix[i] + containersCount, false);
+		}
+		return matrix;
+	}
+
+	// Replays the packing into a Result that starts with every item in an
+	// extra last container, so each item is checked with the same fits()
+	// the searches use, resources and conflicts included.
+	static bool feasible(const Context& context, const std::vector<size_t>& itemsContainers, size_t containersCount)
+	{
+		size_t itemsCount = context.itemsCount();
+		bool** matrix = emptyMatrix(itemsCount, containersCount + 1);
+		for (size_t i = 0; i < itemsCount; ++i)
+			matrix[i][containersCount] = true;
+		Result staged(&context, matrix, containersCount + 1);
+
+		for (size_t i = 0; i < itemsCount; ++i) {
+			if (!context.fits(staged, i, itemsContainers[i]))
+				return false;
+			Move move = relocation(i, containersCount, itemsContainers[i]);
+			staged.apply(move);
+		}
+		return true;
+	}
+
+	ResultInterface* readResult(std::istream& stream, const Context& context)
+	{
+		size_t itemsCount = readSize(stream);
+		size_t containersCount = readSize(stream);
+		if (itemsCount != context.itemsCount() || containersCount == 0 || containersCount > itemsCount)
+			throw 1;
+
+		std::vector<size_t> itemsContainers(itemsCount);
+		std::vector<double> containersWeights(containersCount, 0.0);
+		for (size_t i = 0; i < itemsCount; ++i) {
+			itemsContainers[i] = readSize(stream);
+			if (itemsContainers[i] >= containersCount)
+				throw 1;
+			containersWeights[itemsContainers[i]] += context.itemWeight(i);
+		}
+		std::vector<double> savedWeights(containersCount);
+		for (size_t c = 0; c < containersCount; ++c) {
+			savedWeights[c] = readDouble(stream);
+			if (containersWeights[c] == 0.0 || std::fabs(savedWeights[c] - containersWeights[c]) > weightTolerance)
+				throw 1;
+		}
+		if (!feasible(context, itemsContainers, containersCount))
+			throw 1;
+
+		bool** matrix = emptyMatrix(itemsCount, containersCount);
+		for (size_t i = 0; i < itemsCount; ++i)
+			matrix[i][itemsContainers[i]] = true;
+		return new Result(&context, matrix, containersCount, ::clone(&savedWeights[0], containersCount));
+	}
+
+	class HeavierUnplacedItem
+	{
+	public:
+		HeavierUnplacedItem(const Context& context) : context_(context)
+		{
+		}
+
+		bool operator()(size_t first, size_t second) const
+		{
+			return context_.itemWeight(first) > context_.itemWeight(second);
+		}
+
+	private:
+		const Context& context_;
+	};
+
+	ResultInterface* warmStart(std::istream& stream, const Context& context)
+	{
+		if (!context.weightOnly())
+			throw 1;
+
+		size_t savedItemsCount = readSize(stream);
+		size_t savedContainersCount = readSize(stream);
+		if (savedContainersCount > savedItemsCount)
+			throw 1;
+
+		// Only the saved containers that keep an item are numbered, as they
+		// turn up, so nothing is allocated from the saved counts.
+		size_t itemsCount = context.itemsCount();
+		std::vector<size_t> itemsContainers(itemsCount, 0);
+		std::vector<double> containersWeights;
+		std::map<size_t, size_t> savedContainers;
+		std::vector<size_t> unplaced;
+		for (size_t i = 0; i < savedItemsCount; ++i) {
+			size_t savedContainer = readSize(stream);
+			if (savedContainer >= savedContainersCount)
+				throw 1;
+			if (i >= itemsCount)
+				continue;
+			std::map<size_t, size_t>::iterator numbered = savedContainers.find(savedContainer);
+			if (numbered == savedContainers.end()) {
+				numbered = savedContainers.insert(std::make_pair(savedContainer, containersWeights.size())).first;
+				containersWeights.push_back(0.0);
+			}
+			size_t container = numbered->second;
+			if (context.fits(containersWeights[container] + context.itemWeight(i))) {
+				itemsContainers[i] = container;
+				containersWeights[container] += context.itemWeight(i);
+			} else {
+				unplaced.push_back(i);
+			}
+		}
+		for (size_t c = 0; c < savedContainersCount; ++c)
+			readDouble(stream);
+		for (size_t i = savedItemsCount; i < itemsCount; ++i)
+			unplaced.push_back(i);
+
+		std::sort(unplaced.begin(), unplaced.end(), HeavierUnplacedItem(context));
+		for (size_t u = 0; u < unplaced.size(); ++u) {
+			double weight = context.itemWeight(unplaced[u]);
+			size_t best = containersWeights.size();
+			for (size_t c = 0; c < containersWeights.size(); ++c)
+				if (context.fits(containersWeights[c] + weight) && (best == containersWeights.size() || containersWeights[c] > containersWeights[best]))
+					best = c;
+			if (best == containersWeights.size())
+				containersWeights.push_back(0.0);
+			itemsContainers[unplaced[u]] = best;
+			containersWeights[best] += weight;
+		}
+
+		std::vector<size_t> renumbered(containersWeights.size(), 0);
+		size_t containersCount = 0;
+		for (size_t c = 0; c < containersWeights.size(); ++c)
+			if (containersWeights[c] > 0.0)
+				renumbered[c] = containersCount++;
+
+		bool** matrix = emptyMatrix(itemsCount, containersCount);
+		for (size_t i = 0; i < itemsCount; ++i)
+			matrix[i][renumbered[itemsContainers[i]]] = true;
+		return new Result(&context, matrix, containersCount);
+	}
+}
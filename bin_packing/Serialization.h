@@ -0,0 +1,42 @@
+#ifndef SERIALIZATION_H
+#define SERIALIZATION_H
+
+#include <cstddef>
+#include <iosfwd>
+#include <vector>
+
+namespace bin_packing
+{
+	class Context;
+	class ResultInterface;
+
+	// Compact binary encoding of packings and search state. Numbers are
+	// written as base-128 varints, so a container index usually takes one or
+	// two bytes, and doubles byte for byte. A packing is its items count, its
+	// containers count, the container of every item and the containers'
+	// weights, which are kept as they were summed up incrementally so that a
+	// resumed search compares packings exactly as the interrupted one did.
+	// Readers throw 1 on a truncated stream or one that does not match the
+	// Context, and check every count they read against a bound before
+	// allocating for it.
+	void writeNumber(std::ostream& stream, unsigned long long value);
+	unsigned long long readNumber(std::istream& stream);
+	size_t readSize(std::istream& stream);
+
+	void writeDouble(std::ostream& stream, double value);
+	double readDouble(std::istream& stream);
+
+	void writeSizes(std::ostream& stream, const std::vector<size_t>& values);
+	void readSizes(std::istream& stream, std::vector<size_t>& values, size_t maxCount);
+
+	void writeResult(std::ostream& stream, const ResultInterface& result);
+	ResultInterface* readResult(std::istream& stream, const Context& context);
+
+	// Reads a packing saved for a possibly slightly different instance: items
+	// keep their container while it has room, the rest (including items the
+	// saved packing did not have) are added best fit decreasing and emptied
+	// containers are dropped.
+	ResultInterface* warmStart(std::istream& stream, const Context& context);
+}
+
+#endif // SERIALIZATION_H
@@ -0,0 +1,128 @@
+#include "SolverService.h"
+#include "Context.h"
+#include "ResultInterface.h"
+#include "Algorithms.h"
+#include "Packing.h"
+#include "NullBuffer.h"
+
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cmath>
+
+namespace bin_packing
+{
+	// Above this many items the n x m matrix of Result does not fit, so the
+	// request goes to largeInstanceSearch on a Packing instead.
+	static const size_t largeRequestItems = 5000;
+
+	// Starts from the minimum bin slack packing and runs one reactive tabu
+	// search on it until the time limit or the L1 lower bound. Any failure,
+	// running out of memory included, answers "<id> error" and leaves the
+	// service running.
+	class SolveTask : public Task
+	{
+	public:
+		SolveTask(SolverService& service, const std::string& id, double timeLimit, double containerCapacity, const std::vector<double>& weights) :
+			service_(service), id_(id), deadline_(wallSeconds() + timeLimit), containerCapacity_(containerCapacity), weights_(weights)
+		{
+		}
+
+		virtual void run()
+		{
+			std::stringstream response;
+			response << id_;
+			double* items = new double[weights_.size()];
+			try {
+				double totalWeight = 0.0;
+				for (size_t i = 0; i < weights_.size(); ++i) {
+					items[i] = weights_[i];
+					totalWeight += weights_[i];
+				}
+				size_t lowerBound = static_cast<size_t>(std::ceil(totalWeight / containerCapacity_ - 1e-9));
+				Context context(containerCapacity_, weights_.size(), items, lowerBound);
+				context.setStartGenerator(Context::MinimumBinSlack);
+				NullBuffer silence;
+				std::ostream log(&silence);
+				context.setLog(log);
+
+				if (weights_.size() > largeRequestItems) {
+					// Emptied containers of a Packing keep their index, so the
+					// response numbers the containers again densely.
+					Packing* packing = timedLargeInstanceSearch(context, deadline_);
+					response << ' ' << packing->containersCount();
+					std::vector<size_t> numbers(weights_.size(), Packing::noContainer);
+					size_t numbersCount = 0;
+					for (size_t i = 0; i < weights_.size(); ++i) {
+						size_t& number = numbers[packing->containerOf(i)];
+						if (number == Packing::noContainer)
+							number = numbersCount++;
+						response << ' ' << number;
+					}
+					delete packing;
+				} else {
+					ResultInterface* result = timedReactiveTabuSearch(context, context.createRandomResult(), deadline_);
+					response << ' ' << result->containersCount();
+					for (size_t i = 0; i < weights_.size(); ++i)
+						response << ' ' << result->containerOf(i);
+					delete result;
+				}
+			} catch (...) {
+				response.str(id_ + " error");
+			}
+			delete[] items;
+			service_.respond(response.str());
+		}
+
+	private:
+		SolverService& service_;
+		std::string id_;
+		double deadline_;
+		double containerCapacity_;
+		std::vector<double> weights_;
+	};
+
+	SolverService::SolverService(size_t threadsCount, std::ostream& output) : output_(output), pool_(new ThreadPool(threadsCount))
+	{
+	}
+
+	SolverService::~SolverService()
+	{
+		delete pool_;
+	}
+
+	void SolverService::serve(std::istream& input)
+	{
+		std::string line;
+		while (std::getline(input, line)) {
+			std::stringstream request(line);
+			std::string id;
+			double timeLimit, containerCapacity;
+			size_t itemsCount;
+			if (!(request >> id))
+				continue;
+			// Every weight takes at least two characters of the line.
+			if (!(request >> timeLimit >> containerCapacity >> itemsCount) || containerCapacity <= 0.0 || itemsCount == 0 || itemsCount > line.size() / 2) {
+				respond(id + " error");
+				continue;
+			}
+
+			std::vector<double> weights(itemsCount);
+			bool valid = true;
+			for (size_t i = 0; i < itemsCount && valid; ++i)
+				valid = (request >> weights[i]) && weights[i] > 0.0 && weights[i] <= containerCapacity;
+			if (!valid) {
+				respond(id + " error");
+				continue;
+			}
+			pool_->submit(new SolveTask(*this, id, timeLimit / 1000.0, containerCapacity, weights));
+		}
+	}
+
+	void SolverService::respond(const std::string& response)
+	{
+		Lock lock(outputMutex_);
+		output_ << response << std::endl;
+	}
+}
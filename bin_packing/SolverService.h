@@ -0,0 +1,40 @@
+#ifndef SOLVER_SERVICE_H
+#define SOLVER_SERVICE_H
+
+#include "Threads.h"
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+
+namespace bin_packing
+{
+	// Long-running solver that reads one request per line,
+	//     <id> <time limit in ms> <capacity> <items count> <weight>...
+	// solves the requests concurrently on a thread pool that lives as long
+	// as the service, and writes one line per request to the output as soon
+	// as it is solved,
+	//     <id> <containers count> <container of every item>
+	// or "<id> error" when the request cannot be read or solved. The time
+	// limit runs from when the request is read, so it also covers the wait
+	// for a free thread. Every request gets a context of its own, and so its
+	// own random generator, with the search progress log discarded; only
+	// responses reach the output. Large requests are packed by
+	// largeInstanceSearch, which keeps no item x container matrix.
+	class SolverService
+	{
+	public:
+		SolverService(size_t threadsCount, std::ostream& output);
+		~SolverService();
+
+		void serve(std::istream& input);
+		void respond(const std::string& response);
+
+	private:
+		std::ostream& output_;
+		Mutex outputMutex_;
+		ThreadPool* pool_;
+	};
+}
+
+#endif // SOLVER_SERVICE_H
@@ -0,0 +1,57 @@
+#include "SubsetSum.h"
+
+#include <climits>
+
+namespace bin_packing
+{
+	static const size_t wordBits = sizeof(unsigned long) * CHAR_BIT;
+
+	SubsetSum::SubsetSum(size_t capacity) : capacity_(capacity), wordsCount_(capacity / wordBits + 1)
+	{
+	}
+
+	size_t SubsetSum::solve(const std::vector<size_t>& weights, std::vector<bool>& chosen)
+	{
+		rows_.assign((weights.size() + 1) * wordsCount_, 0);
+		rows_[0] = 1;
+
+		for (size_t i = 0; i < weights.size(); ++i) {
+			const Word* previous = &rows_[i * wordsCount_];
+			Word* current = &rows_[(i + 1) * wordsCount_];
+			size_t wordShift = weights[i] / wordBits;
+			size_t bitShift = weights[i] % wordBits;
+
+			for (size_t w = 0; w < wordsCount_; ++w) {
+				Word shifted = 0;
+				if (w >= wordShift) {
+					shifted = previous[w - wordShift] << bitShift;
+					if (bitShift != 0 && w > wordShift)
+						shifted |= previous[w - wordShift - 1] >> (wordBits - bitShift);
+				}
+				current[w] = previous[w] | shifted;
+			}
+			size_t tailBits = (capacity_ + 1) % wordBits;
+			if (tailBits != 0)
+				current[wordsCount_ - 1] &= (static_cast<Word>(1) << tailBits) - 1;
+		}
+
+		size_t total = capacity_;
+		while (!reachable(weights.size(), total))
+			--total;
+
+		chosen.assign(weights.size(), false);
+		size_t remaining = total;
+		for (size_t i = weights.size(); i > 0; --i) {
+			if (!reachable(i - 1, remaining)) {
+				chosen[i - 1] = true;
+				remaining -= weights[i - 1];
+			}
+		}
+		return total;
+	}
+
+	bool SubsetSum::reachable(size_t row, size_t total) const
+	{
+		return ((rows_[row * wordsCount_ + total / wordBits] >> (total % wordBits)) & 1) != 0;
+	}
+}
@@ -0,0 +1,31 @@
+#ifndef SUBSET_SUM_H
+#define SUBSET_SUM_H
+
+#include <cstddef>
+#include <vector>
+
+namespace bin_packing
+{
+	// Bitset subset-sum DP for integer weights: row i holds the totals
+	// reachable with the first i weights and is built from row i - 1 with
+	// one shift-or per machine word, so a capacity 150 instance costs a few
+	// words per item.
+	class SubsetSum
+	{
+	public:
+		SubsetSum(size_t capacity);
+
+		size_t solve(const std::vector<size_t>& weights, std::vector<bool>& chosen);
+
+	private:
+		typedef unsigned long Word;
+
+		bool reachable(size_t row, size_t total) const;
+
+		size_t capacity_;
+		size_t wordsCount_;
+		std::vector<Word> rows_;
+	};
+}
+
+#endif // SUBSET_SUM_H
@@ -0,0 +1,253 @@
+#include "Threads.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace bin_packing
+{
+#ifdef _WIN32
+	struct Mutex::Native
+	{
+		CRITICAL_SECTION section;
+	};
+
+	Mutex::Mutex() : native_(new Native)
+	{
+		InitializeCriticalSection(&native_->section);
+	}
+
+	Mutex::~Mutex()
+	{
+		DeleteCriticalSection(&native_->section);
+		delete native_;
+	}
+
+	void Mutex::lock()
+	{
+		EnterCriticalSection(&native_->section);
+	}
+
+	void Mutex::unlock()
+	{
+		LeaveCriticalSection(&native_->section);
+	}
+
+	struct Semaphore::Native
+	{
+		HANDLE handle;
+	};
+
+	Semaphore::Semaphore(size_t count) : native_(new Native)
+	{
+		native_->handle = CreateSemaphore(0, static_cast<LONG>(count), MAXLONG, 0);
+		if (native_->handle == 0)
+			throw 1;
+	}
+
+	Semaphore::~Semaphore()
+	{
+		CloseHandle(native_->handle);
+		delete native_;
+	}
+
+	void Semaphore::wait()
+	{
+		WaitForSingleObject(native_->handle, INFINITE);
+	}
+
+	void Semaphore::post()
+	{
+		ReleaseSemaphore(native_->handle, 1, 0);
+	}
+
+	struct ThreadPool::Native
+	{
+		HANDLE handle;
+
+		static DWORD WINAPI start(LPVOID pool)
+		{
+			static_cast<ThreadPool*>(pool)->work();
+			return 0;
+		}
+	};
+#else
+	struct Mutex::Native
+	{
+		pthread_mutex_t mutex;
+	};
+
+	Mutex::Mutex() : native_(new Native)
+	{
+		pthread_mutex_init(&native_->mutex, 0);
+	}
+
+	Mutex::~Mutex()
+	{
+		pthread_mutex_destroy(&native_->mutex);
+		delete native_;
+	}
+
+	void Mutex::lock()
+	{
+		pthread_mutex_lock(&native_->mutex);
+	}
+
+	void Mutex::unlock()
+	{
+		pthread_mutex_unlock(&native_->mutex);
+	}
+
+	struct Semaphore::Native
+	{
+		pthread_mutex_t mutex;
+		pthread_cond_t condition;
+		size_t count;
+	};
+
+	Semaphore::Semaphore(size_t count) : native_(new Native)
+	{
+		pthread_mutex_init(&native_->mutex, 0);
+		pthread_cond_init(&native_->condition, 0);
+		native_->count = count;
+	}
+
+	Semaphore::~Semaphore()
+	{
+		pthread_cond_destroy(&native_->condition);
+		pthread_mutex_destroy(&native_->mutex);
+		delete native_;
+	}
+
+	void Semaphore::wait()
+	{
+		pthread_mutex_lock(&native_->mutex);
+		while (native_->count == 0)
+			pthread_cond_wait(&native_->condition, &native_->mutex);
+		--native_->count;
+		pthread_mutex_unlock(&native_->mutex);
+	}
+
+	void Semaphore::post()
+	{
+		pthread_mutex_lock(&native_->mutex);
+		++native_->count;
+		pthread_cond_signal(&native_->condition);
+		pthread_mutex_unlock(&native_->mutex);
+	}
+
+	struct ThreadPool::Native
+	{
+		pthread_t thread;
+
+		static void* start(void* pool)
+		{
+			static_cast<ThreadPool*>(pool)->work();
+			return 0;
+		}
+	};
+#endif
+
+	ThreadPool::ThreadPool(size_t threadsCount) : queued_(0)
+	{
+		if (threadsCount == 0)
+			throw 1;
+		threads_.reserve(threadsCount);
+		try {
+			for (size_t t = 0; t < threadsCount; ++t) {
+				Native* native = new Native;
+#ifdef _WIN32
+				native->handle = CreateThread(0, 0, Native::start, this, 0, 0);
+				bool started = native->handle != 0;
+#else
+				bool started = pthread_create(&native->thread, 0, Native::start, this) == 0;
+#endif
+				if (!started) {
+					delete native;
+					throw 1;
+				}
+				threads_.push_back(native);
+			}
+		} catch (...) {
+			stop();
+			throw;
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		stop();
+	}
+
+	// A null task tells one worker to stop, once the tasks before it are done.
+	void ThreadPool::stop()
+	{
+		for (size_t t = 0; t < threads_.size(); ++t)
+			submit(0);
+		for (size_t t = 0; t < threads_.size(); ++t) {
+#ifdef _WIN32
+			WaitForSingleObject(threads_[t]->handle, INFINITE);
+			CloseHandle(threads_[t]->handle);
+#else
+			pthread_join(threads_[t]->thread, 0);
+#endif
+			delete threads_[t];
+		}
+	}
+
+	void ThreadPool::submit(Task* task)
+	{
+		{
+			Lock lock(mutex_);
+			tasks_.push_back(task);
+		}
+		queued_.post();
+	}
+
+	void ThreadPool::work()
+	{
+		while (true) {
+			queued_.wait();
+			Task* task;
+			{
+				Lock lock(mutex_);
+				task = tasks_.front();
+				tasks_.pop_front();
+			}
+			if (task == 0)
+				return;
+			task->run();
+			delete task;
+		}
+	}
+
+	double wallSeconds()
+	{
+#ifdef _WIN32
+		LARGE_INTEGER frequency, counter;
+		QueryPerformanceFrequency(&frequency);
+		QueryPerformanceCounter(&counter);
+		return static_cast<double>(counter.QuadPart) / static_cast<double>(frequency.QuadPart);
+#else
+		timeval now;
+		gettimeofday(&now, 0);
+		return static_cast<double>(now.tv_sec) + static_cast<double>(now.tv_usec) * 1e-6;
+#endif
+	}
+
+	size_t hardwareThreadsCount()
+	{
+#ifdef _WIN32
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		return static_cast<size_t>(info.dwNumberOfProcessors);
+#else
+		long count = sysconf(_SC_NPROCESSORS_ONLN);
+		return count > 0 ? static_cast<size_t>(count) : 1;
+#endif
+	}
+}
@@ -0,0 +1,107 @@
+#ifndef THREADS_H
+#define THREADS_H
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+namespace bin_packing
+{
+	// Minimal threading layer over Win32 or pthreads, since the compiler has
+	// no std::thread. Native handles stay in Threads.cpp so that neither
+	// windows.h nor pthread.h leaks into the rest of the solver.
+	class Mutex
+	{
+	public:
+		Mutex();
+		~Mutex();
+
+		void lock();
+		void unlock();
+
+	private:
+		Mutex(const Mutex&);
+		Mutex& operator=(const Mutex&);
+
+		struct Native;
+		Native* native_;
+	};
+
+	class Lock
+	{
+	public:
+		Lock(Mutex& mutex) : mutex_(mutex)
+		{
+			mutex_.lock();
+		}
+
+		~Lock()
+		{
+			mutex_.unlock();
+		}
+
+	private:
+		Lock(const Lock&);
+		Lock& operator=(const Lock&);
+
+		Mutex& mutex_;
+	};
+
+	class Semaphore
+	{
+	public:
+		Semaphore(size_t count);
+		~Semaphore();
+
+		void wait();
+		void post();
+
+	private:
+		Semaphore(const Semaphore&);
+		Semaphore& operator=(const Semaphore&);
+
+		struct Native;
+		Native* native_;
+	};
+
+	class Task
+	{
+	public:
+		virtual ~Task() {};
+
+		virtual void run() = 0;
+	};
+
+	// Fixed set of worker threads that live as long as the pool and run the
+	// submitted tasks in order of submission. The pool owns the tasks; the
+	// destructor runs the ones still queued and then joins the workers. If a
+	// worker cannot be started, the ones already running are joined before
+	// the constructor throws.
+	class ThreadPool
+	{
+	public:
+		ThreadPool(size_t threadsCount);
+		~ThreadPool();
+
+		void submit(Task* task);
+
+	private:
+		ThreadPool(const ThreadPool&);
+		ThreadPool& operator=(const ThreadPool&);
+
+		void work();
+		void stop();
+
+		Mutex mutex_;
+		Semaphore queued_;
+		std::deque<Task*> tasks_;
+
+		struct Native;
+		std::vector<Native*> threads_;
+	};
+
+	double wallSeconds();
+	size_t hardwareThreadsCount();
+}
+
+#endif // THREADS_H
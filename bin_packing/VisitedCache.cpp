@@ -0,0 +1,90 @@
+#include "VisitedCache.h"
+#include "Serialization.h"
+
+namespace bin_packing
+{
+	VisitedCache::VisitedCache(size_t capacity)
+	{
+		size_t setsCount = 1;
+		while (setsCount * ways < capacity)
+			setsCount *= 2;
+		setsMask_ = setsCount - 1;
+		entries_.resize(setsCount * ways);
+		clear();
+	}
+
+	VisitedCache::Entry* VisitedCache::find(PackingHash hash)
+	{
+		Entry* entries = set(hash);
+		for (size_t w = 0; w < ways; ++w)
+			if (entries[w].visitsCount > 0 && entries[w].hash == hash)
+				return &entries[w];
+		return 0;
+	}
+
+	VisitedCache::Entry& VisitedCache::insert(PackingHash hash, size_t step)
+	{
+		Entry* entries = set(hash);
+		Entry* victim = &entries[0];
+		for (size_t w = 0; w < ways; ++w) {
+			if (entries[w].visitsCount == 0 || entries[w].hash == hash) {
+				victim = &entries[w];
+				break;
+			}
+			if (entries[w].lastStep < victim->lastStep)
+				victim = &entries[w];
+		}
+		victim->hash = hash;
+		victim->lastStep = step;
+		victim->visitsCount = 1;
+		return *victim;
+	}
+
+	void VisitedCache::clear()
+	{
+		for (size_t i = 0; i < entries_.size(); ++i)
+			entries_[i].visitsCount = 0;
+	}
+
+	void VisitedCache::write(std::ostream& stream) const
+	{
+		size_t usedCount = 0;
+		for (size_t i = 0; i < entries_.size(); ++i)
+			if (entries_[i].visitsCount > 0)
+				++usedCount;
+
+		writeNumber(stream, entries_.size());
+		writeNumber(stream, usedCount);
+		for (size_t i = 0; i < entries_.size(); ++i) {
+			if (entries_[i].visitsCount == 0)
+				continue;
+			writeNumber(stream, i);
+			writeNumber(stream, entries_[i].hash);
+			writeNumber(stream, entries_[i].lastStep);
+			writeNumber(stream, entries_[i].visitsCount);
+		}
+	}
+
+	void VisitedCache::read(std::istream& stream)
+	{
+		if (readSize(stream) != entries_.size())
+			throw 1;
+		clear();
+		size_t usedCount = readSize(stream);
+		if (usedCount > entries_.size())
+			throw 1;
+		for (size_t u = 0; u < usedCount; ++u) {
+			size_t i = readSize(stream);
+			if (i >= entries_.size())
+				throw 1;
+			entries_[i].hash = readNumber(stream);
+			entries_[i].lastStep = readSize(stream);
+			entries_[i].visitsCount = readSize(stream);
+		}
+	}
+
+	VisitedCache::Entry* VisitedCache::set(PackingHash hash)
+	{
+		return &entries_[(static_cast<size_t>(hash >> 32) & setsMask_) * ways];
+	}
+}
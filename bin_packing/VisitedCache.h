@@ -0,0 +1,48 @@
+#ifndef VISITED_CACHE_H
+#define VISITED_CACHE_H
+
+#include "PackingHash.h"
+
+#include <cstddef>
+#include <iosfwd>
+#include <vector>
+
+namespace bin_packing
+{
+	// Bounded set of visited packings keyed by their hash, with when each
+	// was last seen and how often. It is four-way set associative: a new
+	// packing evicts the least recently visited entry of its set, so memory
+	// stays fixed however long a search runs. A cache belongs to a single
+	// search and is not locked; searches running on several threads, as in
+	// the solver service, each own one, since hashes of different instances
+	// have nothing in common.
+	class VisitedCache
+	{
+	public:
+		struct Entry
+		{
+			PackingHash hash;
+			size_t lastStep;
+			size_t visitsCount;
+		};
+
+		VisitedCache(size_t capacity);
+
+		Entry* find(PackingHash hash);
+		Entry& insert(PackingHash hash, size_t step);
+		void clear();
+
+		void write(std::ostream& stream) const;
+		void read(std::istream& stream);
+
+	private:
+		enum { ways = 4 };
+
+		Entry* set(PackingHash hash);
+
+		std::vector<Entry> entries_;
+		size_t setsMask_;
+	};
+}
+
+#endif // VISITED_CACHE_H
@@ -4,10 +4,18 @@
 #include <ctime>
 #include <fstream>
 #include <cstdlib>
+#include <vector>
+#include <sstream>
+#include <cmath>
 
 #include "Context.h"
+#include "ConflictGraph.h"
 #include "Result.h"
-#include "Range.h"
+#include "Packing.h"
+#include "InstanceGenerator.h"
+#include "Serialization.h"
+#include "SolverService.h"
+#include "AlgorithmSelector.h"
 
 #include "Algorithms.h"
 
@@ -59,9 +67,230 @@ private:
 	std::string filename_;
 };
 
-int main()
+// Vector packing instances: the dimensions count, the capacity of every
+// dimension, the items count and the best known number of containers,
+// followed by the resources every item needs in each dimension.
+class VectorDataLoader
+{
+public:
+	VectorDataLoader(const std::string& filename) : filename_(filename)
+	{
+	}
+
+	Context* load()
+	{
+		std::ifstream file(filename_.c_str(), std::ios::in);
+		if (!file.is_open())
+			throw 1;
+
+		size_t dimensionsCount;
+		if (!(file >> dimensionsCount) || dimensionsCount == 0)
+			throw 1;
+		std::vector<double> capacities(dimensionsCount);
+		for (size_t k = 0; k < dimensionsCount; ++k)
+			file >> capacities[k];
+
+		size_t itemsCount, bestKnownNumberOfContainers;
+		file >> itemsCount >> bestKnownNumberOfContainers;
+		if (!file || itemsCount == 0)
+			throw 1;
+		std::vector<double> resources(itemsCount * dimensionsCount);
+		for (size_t j = 0; j < resources.size(); ++j)
+			file >> resources[j];
+		if (!file)
+			throw 1;
+		file.close();
+		return new Context(dimensionsCount, &capacities[0], itemsCount, &resources[0], bestKnownNumberOfContainers);
+	}
+
+private:
+	std::string filename_;
+};
+
+// Bin packing with conflicts instances: the items count and the capacity,
+// then for every item its index, its weight and the indexes of the items it
+// conflicts with, all on one line and counted from 1.
+class ConflictDataLoader
+{
+public:
+	ConflictDataLoader(const std::string& filename) : filename_(filename)
+	{
+	}
+
+	Context* load()
+	{
+		std::ifstream file(filename_.c_str(), std::ios::in);
+		if (!file.is_open())
+			throw 1;
+
+		size_t itemsCount;
+		double containerCapacity;
+		if (!(file >> itemsCount >> containerCapacity) || itemsCount == 0)
+			throw 1;
+
+		double* items = new double[itemsCount];
+		ConflictGraph conflicts(itemsCount);
+		double totalWeight = 0.0;
+		std::string s;
+		std::getline(file, s, '\n');
+		for (size_t i = 0; i < itemsCount; ++i) {
+			std::getline(file, s, '\n');
+			std::stringstream line(s);
+			size_t index, other;
+			if (!(line >> index >> items[i]) || index != i + 1) {
+				delete[] items;
+				throw 1;
+			}
+			totalWeight += items[i];
+			while (line >> other)
+				conflicts.add(i, other - 1);
+		}
+		file.close();
+
+		size_t lowerBound = static_cast<size_t>(std::ceil(totalWeight / containerCapacity - 1e-9));
+		Context* context = new Context(containerCapacity, itemsCount, items, lowerBound);
+		context->setConflicts(conflicts);
+		return context;
+	}
+
+private:
+	std::string filename_;
+};
+
+int main(int argc, char* argv[])
 {
 	std::srand(0);//static_cast<unsigned int>(std::time(0)));
+
+	if ((argc == 2 || argc == 3) && std::string(argv[1]) == "service") {
+		size_t threadsCount = hardwareThreadsCount();
+		if (argc == 3) {
+			char* end;
+			threadsCount = std::strtoul(argv[2], &end, 10);
+			if (*end != '\0' || threadsCount == 0) {
+				std::cerr << "usage: bin_packing service [threads count, at least 1]\n";
+				return 1;
+			}
+		}
+		try {
+			SolverService service(threadsCount, std::cout);
+			service.serve(std::cin);
+		} catch (...) {
+			std::cerr << "cannot start " << threadsCount << " threads\n";
+			return 1;
+		}
+		return 0;
+	}
+
+	if (argc == 6 && std::string(argv[1]) == "generate") {
+		InstanceGenerator::Kind kind = std::string(argv[2]) == "triplet" ? InstanceGenerator::Triplet : InstanceGenerator::Uniform;
+		InstanceGenerator generator(kind, std::strtoul(argv[3], 0, 10));
+		generator.write(argv[5], std::strtoul(argv[4], 0, 10));
+		return 0;
+	}
+
+	if (argc == 4 && std::string(argv[1]) == "large") {
+		DataLoader largeLoader(argv[2]);
+		Context* context = largeLoader.load(std::strtoul(argv[3], 0, 10));
+		Packing* packing = largeInstanceSearch(*context);
+		std::cout << packing->containersCount() << " - " << context->bestKnownNumberOfContainers() << '\n';
+		delete packing;
+		delete context;
+		return 0;
+	}
+
+	if (argc == 3 && std::string(argv[1]) == "vector") {
+		VectorDataLoader vectorLoader(argv[2]);
+		Context* context = vectorLoader.load();
+		ResultInterface* result = reactiveTabuSearch(*context);
+		std::cout << result->containersCount() << " - " << context->bestKnownNumberOfContainers() << '\n';
+		delete result;
+		delete context;
+		return 0;
+	}
+
+	if (argc == 3 && std::string(argv[1]) == "conflicts") {
+		ConflictDataLoader conflictLoader(argv[2]);
+		Context* context = conflictLoader.load();
+		ResultInterface* result = reactiveTabuSearch(*context);
+		std::cout << result->containersCount() << " - " << context->bestKnownNumberOfContainers() << '\n';
+		delete result;
+		delete context;
+		return 0;
+	}
+
+	if (argc >= 5 && std::string(argv[1]) == "tune") {
+		size_t setsCount = std::strtoul(argv[3], 0, 10);
+		std::vector<Context*> contexts;
+		for (int f = 4; f < argc; ++f) {
+			DataLoader tuneLoader(argv[f]);
+			for (size_t set = 0; set < setsCount; ++set)
+				contexts.push_back(tuneLoader.load(set));
+		}
+		AlgorithmSelector selector;
+		selector.tune(contexts);
+		std::ofstream table(argv[2], std::ios::out);
+		selector.write(table);
+		table.close();
+		for (size_t c = 0; c < contexts.size(); ++c)
+			delete contexts[c];
+		return 0;
+	}
+
+	if ((argc == 4 || argc == 5) && std::string(argv[1]) == "auto") {
+		DataLoader autoLoader(argv[2]);
+		Context* context = autoLoader.load(std::strtoul(argv[3], 0, 10));
+		AlgorithmSelector selector;
+		if (argc == 5) {
+			std::ifstream table(argv[4], std::ios::in);
+			if (!table.is_open())
+				throw 1;
+			selector.read(table);
+			table.close();
+		}
+		ResultInterface* result = selector.solve(*context);
+		std::cout << result->containersCount() << " - " << context->bestKnownNumberOfContainers() << '\n';
+		delete result;
+		delete context;
+		return 0;
+	}
+
+	if (argc == 5 && std::string(argv[1]) == "solve") {
+		DataLoader solveLoader(argv[2]);
+		Context* context = solveLoader.load(std::strtoul(argv[3], 0, 10));
+		std::string solutionPath = argv[4];
+		std::string checkpointPath = solutionPath + ".checkpoint";
+
+		ResultInterface* initialResult = 0;
+		std::ifstream previous(solutionPath.c_str(), std::ios::in | std::ios::binary);
+		if (previous.is_open()) {
+			initialResult = warmStart(previous, *context);
+			previous.close();
+		} else {
+			initialResult = context->createRandomResult();
+		}
+
+		ResultInterface* result = reactiveTabuSearch(*context, initialResult, 2000, checkpointPath.c_str());
+		std::ofstream solution(solutionPath.c_str(), std::ios::out | std::ios::binary);
+		writeResult(solution, *result);
+		solution.close();
+		std::cout << result->containersCount() << " - " << context->bestKnownNumberOfContainers() << '\n';
+		delete result;
+		delete context;
+		return 0;
+	}
+
+	if (argc == 7 && std::string(argv[1]) == "island") {
+		DataLoader islandLoader(argv[2]);
+		Context* context = islandLoader.load(std::strtoul(argv[3], 0, 10));
+		size_t islandId = std::strtoul(argv[5], 0, 10);
+		context->random().seed(islandId);
+		ResultInterface* result = islandSearch(*context, argv[4], islandId, std::strtoul(argv[6], 0, 10));
+		std::cout << result->containersCount() << " - " << context->bestKnownNumberOfContainers() << '\n';
+		delete result;
+		delete context;
+		return 0;
+	}
+
 	DataLoader loader("data/binpack1.txt");
 	double data[8] = {7, 5, 3, 9, 1, 6, 5, 4 };
     size_t count = 0;